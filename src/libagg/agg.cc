@@ -41,7 +41,6 @@ agg::agg(int numPlayers,int* _actions, int numANodes, int _numPNodes,
  vector<vector<vector<config> > >& proj,
  vector<vector<proj_func*> > & projF,
  vector<vector<vector<int> > >& Po,
- vector<aggdistrib> &P,
  vector<aggpayoff>& _payoffs) :
 numPlayers(numPlayers),
 numActionNodes(numANodes),
@@ -51,16 +50,14 @@ neighbors(neighb),
 projectionTypes(projTypes),
 payoffs(_payoffs),
 projection(proj),
-projectedStrat(projS),
 fullProjectedStrat(projS),
 projFunctions(projF),
 Porder(Po),
-Pr(P),
 isPure(numANodes,true),
 node2Action(numANodes,vector<int>(numPlayers)),
-cache(numPlayers+1),
 player2Class(numPlayers),
-kSymStrategyOffset(1,0)
+kSymStrategyOffset(1,0),
+workspace(*this)
 {
 
   //actions
@@ -129,8 +126,56 @@ kSymStrategyOffset(1,0)
     for(int j=0;j<actions[i];j++)
 	node2Action[actionSets[i][j]][i]=j;
 
+  //find the extreme payoffs
+  assert(numANodes>0 && !payoffs[0].empty());
+  maxPayoff=minPayoff=payoffs[0].begin()->second;
+  for (int i=0;i<numANodes;i++)
+    for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it){
+      maxPayoff=max(maxPayoff, it->second);
+      minPayoff=min(minPayoff, it->second);
+    }
+
+  //bound the configurations of each node by those of its payoffs and
+  //the contributions to them.  they are looked up in a dense array if
+  //there are few configurations within the bounds, or if most of them
+  //occur, and in a hash table otherwise.
+  for (int i=0;i<numANodes;i++){
+    int numNei=neighbors[i].size();
+    vector<int> radix(numNei,1);
+    bool bounded=true;
+    for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it){
+      for (int k=0;k<numNei;k++){
+	bounded=bounded && it->first[k]>=0;
+	radix[k]=max(radix[k],it->first[k]+1);
+      }
+    }
+    for (int j=0;j<numPlayers;j++){
+      for (size_t a=0;a<projection[i][j].size();a++){
+	for (int k=0;k<numNei;k++){
+	  bounded=bounded && projection[i][j][a][k]>=0;
+	  radix[k]=max(radix[k],projection[i][j][a][k]+1);
+	}
+      }
+    }
+    double size=1.0;
+    for (int k=0;k<numNei;k++) size*=radix[k];
+    if (!bounded || size>=(double)((size_t)-1)){
+      keyLayouts.push_back(NULL);
+      continue;
+    }
+    bool dense=(size<=(double)(1<<12) ||
+		(size<=4.0*payoffs[i].size() && size<=(double)(1<<16)));
+    keyLayouts.push_back(new key_layout(radix,dense));
+    payoffs[i].setLayout(keyLayouts[i]);
+  }
 }
 
+agg::Workspace::Workspace(const agg &game) :
+projectedStrat(game.getNumActionNodes()),
+Pr(game.getNumPlayers()),
+cache(game.getNumPlayers()+1)
+{}
+
 /*
 agg::agg(const agg& other, bool completeGraph)
 :
@@ -386,7 +431,7 @@ agg* agg::makeAGG(istream &in){
       
     }
     agg* r=NULL;
-    r=new agg(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
+    r=new agg(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
     if (!r)cout<<"Failed to allocate memory for new AGG";
     delete [] size;
     return r;
@@ -453,7 +498,7 @@ vector<projtype>& projTypes, int seed, bool int_payoffs, int int_factor){
 	    numPayoffs += pays[i].size();
     }
     cout << "Creating an AGG with "<<numPayoffs <<" payoff values"<<endl;
-    agg* r= new agg(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
+    agg* r= new agg(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
     
     return r;
  
@@ -575,10 +620,12 @@ agg::initPorder(vector<int>& Po,
 
 //compute the induced distribution 
 void
-agg::computeP(int player, int act, int player2,int act2)
+agg::computeP(Workspace &w, int player, int act, int player2,int act2)
 {
+  vector<aggdistrib> &Pr = w.Pr;
   //apply player's strat
   Pr[0].reset();
+  Pr[0].setLayout(keyLayouts[actionSets[player][act]]);
   Pr[0].insert(make_pair(projection[actionSets[player][act]][player][act], 1.0) );
 
   int numNei = neighbors[actionSets[player][act]].size();
@@ -597,25 +644,52 @@ agg::computeP(int player, int act, int player2,int act2)
       }
     } else {
       Pr[k].multiply (Pr[k-1], 
-	projectedStrat[actionSets[player][act]][Porder[player][act][k]],
+	w.projectedStrat[actionSets[player][act]][Porder[player][act][k]],
 	numNei  ,projFunctions[actionSets[player][act]] ); 
     }
   }
     
 }
 
-void agg:: doProjection(int Node, AggNumber* s)
+//compute the distribution induced by player's action act and the
+//strategies of the others except player2 (-1 for none), applying
+//them in the same order as computeP().
+//returns the index in w.Pr of the result.
+int
+agg::computePartialP(Workspace &w, int player, int act, int player2)
+{
+  int node = actionSets[player][act];
+  int numNei = neighbors[node].size();
+  vector<aggdistrib> &Pr = w.Pr;
+  Pr[0].reset();
+  Pr[0].setLayout(keyLayouts[node]);
+  Pr[0].insert(make_pair(projection[node][player][act], 1.0) );
+
+  int last = 0;
+  for (int k=1; k<numPlayers; k++){
+    int other = Porder[player][act][k];
+    if (other == player2) continue;
+    Pr[last+1].multiply(Pr[last], w.projectedStrat[node][other],
+	numNei, projFunctions[node]);
+    last++;
+  }
+  return last;
+}
+
+void agg:: doProjection(Workspace &w, int Node, AggNumber* s)
 {
   for (int i=0;i<numPlayers;i++){
-    doProjection(Node,i, &(s[firstAction(i)]));
+    doProjection(w, Node,i, &(s[firstAction(i)]));
   }
 }
 
-inline void agg:: doProjection(int Node, int i, AggNumber* s)
+void agg:: doProjection(Workspace &w, int Node, int i, AggNumber* s)
 {
-  projectedStrat[Node][i].reset();
+  if (w.projectedStrat[Node].empty()) w.projectedStrat[Node].resize(numPlayers);
+  aggdistrib &projS = w.projectedStrat[Node][i];
+  projS.reset();
   for (int j=0;j<actions[i];j++)if(s[j]>(AggNumber)0.0){
-    projectedStrat[Node][i]+= make_pair(projection[Node][i][j],
+    projS+= make_pair(projection[Node][i][j],
               s[j]);
   }
 }
@@ -643,34 +717,75 @@ AggNumber agg::getPurePayoff(int player, int *s){
   return p->second;
 }
 
-AggNumber agg::getMixedPayoff(int player, StrategyProfile &s){
+AggNumber agg::getMixedPayoff(Workspace &w, int player, StrategyProfile &s){
   AggNumber result=0.0;
   assert(player>=0 && player < numPlayers);
   for (int act=0;act <actions[player];++act)if (s[act+firstAction(player)]>(AggNumber)0.0){
-	result+= s[act+firstAction(player)]* getV(player, act, s);
+	result+= s[act+firstAction(player)]* getV(w, player, act, s);
   }
   return result;
 }
 
-void agg::getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s){
+void agg::getPayoffVector(Workspace &w, AggNumberVector &dest, int player,const StrategyProfile &s){
     assert(player>=0 && player < numPlayers);
     for (int act=0;act<actions[player]; ++act){
-	dest[act]=getV(player,act,s);
+	dest[act]=getV(w, player,act,s);
     }
 }
 
-AggNumber agg::getV(int player, int act,const StrategyProfile &s){
+AggNumber agg::getV(Workspace &w, int player, int act,const StrategyProfile &s){
     //project s to the projectedStrat
-    doProjection(actionSets.at(player).at(act), s);
-    computeP(player, act);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
+    doProjection(w, actionSets.at(player).at(act), s);
+    computeP(w, player, act);
+    return w.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
+}
+
+AggNumber agg::getJ(Workspace &w, int player1, int act1, int player2,int act2,StrategyProfile &s)
+{
+    doProjection(w, actionSets[player1][act1],s);
+    computeP(w, player1,act1,player2,act2);
+    return w.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
 }
 
-AggNumber agg::getJ(int player1, int act1, int player2,int act2,StrategyProfile &s)
+//getPayoffDerivs: for each action a of player, the distribution induced
+// by all others gives the payoff to a, and leaving out one more player
+// j gives the payoffs to a against each action of j, which are the
+// entries of the Jacobian in a's row and column.  Leaving out two more
+// players j and k gives the payoffs against each pair of their actions,
+// which are weighted by the probability of a in the entries for j and k.
+
+void agg::getPayoffDerivs(Workspace &w, int player, const StrategyProfile &s,
+                          AggNumberVector &dest, AggNumberVector *jac)
 {
-    doProjection(actionSets[player1][act1],s);
-    computeP(player1,act1,player2,act2);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
+  assert(player>=0 && player < numPlayers);
+  fill(dest.begin(), dest.end(), (AggNumber)0);
+  if (jac) fill(jac->begin(), jac->end(), (AggNumber)0);
+  vector<bool> projected(numActionNodes, false);
+
+  for (int act=0; act<actions[player]; ++act){
+    int node = actionSets[player][act];
+    int numNei = neighbors[node].size();
+    int row = firstAction(player)+act;
+    AggNumber prob = s[row];
+
+    if (!projected[node]){
+      doProjection(w, node, s);
+      projected[node] = true;
+    }
+    dest[row] = w.Pr[computePartialP(w, player, act, -1)].inner_prod(payoffs[node]);
+    if (!jac && !(prob>(AggNumber)0.0)) continue;
+
+    for (int p2=0; p2<numPlayers; ++p2)if (p2!=player){
+      aggdistrib &P2 = w.Pr[computePartialP(w, player, act, p2)];
+      for (int a2=0; a2<actions[p2]; ++a2){
+	int col = firstAction(p2)+a2;
+	AggNumber v = P2.inner_prod(projection[node][p2][a2], numNei,
+				    projFunctions[node], payoffs[node]);
+	if (prob>(AggNumber)0.0) dest[col] += prob * v;
+	if (jac) (*jac)[row*totalActions+col] = v;
+      }
+    }
+  }
 }
 
 //getSymMixedPayoff: compute expected payoff under a symmetric mixed strat,
@@ -678,7 +793,7 @@ AggNumber agg::getJ(int player1, int act1, int player2,int act2,StrategyProfile
 // parameter: s is the mixed strategy of one player. It is a vector of 
 // probabilities, indexed by the action node.
 
-AggNumber agg::getSymMixedPayoff( StrategyProfile &s){
+AggNumber agg::getSymMixedPayoff(Workspace &w, StrategyProfile &s){
   AggNumber result=0;
   if (! isSymmetric() ) {
     cerr<< "agg::getSymMixedPayoff: the game is not symmetric!"<<endl;
@@ -687,11 +802,11 @@ AggNumber agg::getSymMixedPayoff( StrategyProfile &s){
 
 
   for (int node=0; node<numActionNodes; ++node)if(s[node]>(AggNumber)0.0){
-    result+= s[node]* getSymMixedPayoff(node,s);
+    result+= s[node]* getSymMixedPayoff(w, node,s);
   }
   return result;
 }
-void agg::getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s){
+void agg::getSymPayoffVector(Workspace &w, AggNumberVector& dest, StrategyProfile &s){
   if (! isSymmetric() ) {
     cerr<< "agg::getSymMixedPayoff: the game is not symmetric!"<<endl;
     exit(1);
@@ -715,20 +830,20 @@ void agg::getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s){
   //  return;
   //}
   for (int act=0;act<numActionNodes; ++act){
-          dest[act]=getSymMixedPayoff(act,s);
+          dest[act]=getSymMixedPayoff(w, act,s);
   }
 }
-AggNumber agg::getSymMixedPayoff(int node, StrategyProfile &s)
+AggNumber agg::getSymMixedPayoff(Workspace &w, int node, StrategyProfile &s)
 {
     int numNei = neighbors[node].size();
 
     if(!isPure[node]){ // then compute EU using trie_map::power()
-      doProjection(node,0,s);
+      doProjection(w, node,0,s);
       assert(numPlayers>1);
       //aggdistrib *dest;
       //projectedStrat[node][0].power(numPlayers-1, dest, Pr, numNei,projFunctions[node]);
-      aggdistrib &dest = Pr[numPlayers-1];
-      projectedStrat[node][0].power(numPlayers-1, dest, Pr[numPlayers-2],numNei,projFunctions[node]);
+      aggdistrib &dest = w.Pr[numPlayers-1];
+      w.projectedStrat[node][0].power(numPlayers-1, dest, w.Pr[numPlayers-2],numNei,projFunctions[node]);
       return dest.inner_prod(projection[node][0][node], numNei, projFunctions[node], payoffs[node]);
     }
 
@@ -783,7 +898,7 @@ AggNumber agg::getSymMixedPayoff(int node, StrategyProfile &s)
 //plClass: the index for the player class
 //s: mixed strat for that player class
 
-void agg::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2,int act2){
+void agg::getSymConfigProb(Workspace &w, int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2,int act2){
     int node = uniqueActionSets.at(ownPlClass).at(act);
     int numPl = playerClasses.at(plClass).size();
     assert(numPl>0);
@@ -798,12 +913,9 @@ void agg::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
 
     if(!isPure[node]){
       int player = playerClasses[plClass].at(0);
-      projectedStrat[node][player].reset();
       if(numPl>0){
-        for (int j=0;j<actions[player];j++)if(s[j]>(AggNumber)0.0){
-          projectedStrat[node][player]+= make_pair(projection[node][player][j], s[j]);
-        }
-        projectedStrat[node][player].power(numPl, dest,Pr[0],numNei, projFunctions[node]);
+        doProjection(w, node, player, &s[0]);
+        w.projectedStrat[node][player].power(numPl, dest,w.Pr[0],numNei, projFunctions[node]);
       }
       if(plClass==ownPlClass){
         aggdistrib temp;
@@ -888,66 +1000,62 @@ void agg::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
   
 }
 
-AggNumber agg::getKSymMixedPayoff( int playerClass,vector<StrategyProfile> &s){
+AggNumber agg::getKSymMixedPayoff(Workspace &w, int playerClass,vector<StrategyProfile> &s){
   AggNumber result=0.0;
 
   for(int act=0;act<(int)uniqueActionSets[playerClass].size();act++)if(s[playerClass][act]>(AggNumber)0.0){
 
-      result += s[playerClass][act] *getKSymMixedPayoff(playerClass, act,s);
+      result += s[playerClass][act] *getKSymMixedPayoff(w, playerClass, act,s);
   }
   return result;
 }
-AggNumber agg::getKSymMixedPayoff( int playerClass,StrategyProfile &s){
+AggNumber agg::getKSymMixedPayoff(Workspace &w, int playerClass,StrategyProfile &s){
   AggNumber result=0.0;
 
   for(int act=0;act<(int)uniqueActionSets[playerClass].size();act++)if(s[firstKSymAction(playerClass)+act]>(AggNumber)0.0){
 
-      result += s[firstKSymAction(playerClass)+act] *getKSymMixedPayoff(s,playerClass, act);
+      result += s[firstKSymAction(playerClass)+act] *getKSymMixedPayoff(w, s,playerClass, act);
   }
   return result;
 }
-void agg::getKSymPayoffVector(AggNumberVector& dest,int playerClass, StrategyProfile &s){
+void agg::getKSymPayoffVector(Workspace &w, AggNumberVector& dest,int playerClass, StrategyProfile &s){
   for (size_t act=0;act<uniqueActionSets[playerClass].size();++act){
-    dest[act]=getKSymMixedPayoff(s,playerClass,act);
+    dest[act]=getKSymMixedPayoff(w, s,playerClass,act);
   }
 }
-AggNumber agg::getKSymMixedPayoff(int playerClass, int act, vector<StrategyProfile> &s){
+AggNumber agg::getKSymMixedPayoff(Workspace &w, int playerClass, int act, vector<StrategyProfile> &s){
       
       int numPC = playerClasses.size();
       
       int numNei = neighbors[uniqueActionSets[playerClass][act]].size();
 
-      static aggdistrib d,temp;
-      d.reset();
-      temp.reset();
-      getSymConfigProb(0, s[0], playerClass, act, d);
+      aggdistrib d,temp;
+      getSymConfigProb(w, 0, s[0], playerClass, act, d);
       for(int pc=1;pc<numPC;pc++){
-	  getSymConfigProb(pc, s[pc], playerClass, act, temp);
+	  getSymConfigProb(w, pc, s[pc], playerClass, act, temp);
 	  d.multiply(temp, numNei, projFunctions[uniqueActionSets[playerClass][act]]);
       }
       return d.inner_prod(payoffs[uniqueActionSets[playerClass][act]]);
 }
 
-AggNumber agg::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2){
+AggNumber agg::getKSymMixedPayoff(Workspace &w, const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2){
   int numPC=playerClasses.size();
   int numNei=neighbors[uniqueActionSets[pClass1][act1]].size();
-  static aggdistrib d,temp;
   if (pClass2>=0 && pClass1==pClass2 && playerClasses.at(pClass1).size()<=1){
     return 0;
   }
-  d.reset();
-  temp.reset();
+  aggdistrib d,temp;
   StrategyProfile s0(getNumKSymActions(0), 0.0);
   //if (0==pClass2) s0[act2]=1;
   //else
   for (int a=firstKSymAction(0);a<lastKSymAction(0);++a)s0[a]=s[a];
-  getSymConfigProb(0,s0,pClass1,act1,d,pClass2,act2);
+  getSymConfigProb(w, 0,s0,pClass1,act1,d,pClass2,act2);
   for (int pc=1;pc<numPC;pc++){
     StrategyProfile ss(getNumKSymActions(pc), 0.0);
     //if (pc==pClass2)ss[act2]=1;
     //else
     for (int a=0;a<getNumKSymActions(pc);++a)ss[a]=s[a+firstKSymAction(pc)];
-    getSymConfigProb(pc,ss,pClass1,act1,temp,pClass2,act2);
+    getSymConfigProb(w, pc,ss,pClass1,act1,temp,pClass2,act2);
     d.multiply(temp,numNei,projFunctions[uniqueActionSets[pClass1][act1]]);
   }
   return d.inner_prod(payoffs[uniqueActionSets[pClass1][act1]]);
@@ -1055,29 +1163,3 @@ void agg::makeMAPPINGpayoff(std::istream& in, aggpayoff& pay, int numNei){
 
 
 }
-
-AggNumber agg::getMaxPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
-  assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
-    for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
-      result=max(result, it->second);
-
-  done=true;
-  return result;
-}
-AggNumber agg::getMinPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
-  assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
-      for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
-        result=min(result, it->second);
-  done=true;
-  return result;
-}
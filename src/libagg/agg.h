@@ -82,6 +82,36 @@ public:
   friend class aggame;   //wrapper class for gametracer
 
 
+  //scratch space for computing expected payoffs.
+  //The payoff computations do not modify the game itself, so several
+  //threads may share one agg, as long as each passes its own Workspace.
+  class Workspace {
+  public:
+    Workspace(const agg &game);
+
+  private:
+    friend class agg;
+    friend class aggame;
+
+    //foreach s \in S, foreach i \in N, the projected mixed strat
+    //which is a prob distribution over the set of 'contributions'.
+    //The entries for s are allocated when s is first projected.
+    std::vector< std::vector<aggdistrib > > projectedStrat;
+
+    //when computing the induced distribution via ComputeP():
+    //foreach k<= n-1,
+    //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
+
+    //when computing the partial distributions for the payoff jacobian:
+    //  foreach  j \in N,
+    // the partial distribution induced by all agents except j.
+    std::vector<aggdistrib>  Pr;
+
+    //cache of jacobian entries.
+    trie_map<AggNumber> cache;
+  };
+
+
   //read an AGG from a file
   static agg* makeAGG(char* filename);
 
@@ -102,7 +132,6 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
    std::vector<std::vector<std::vector<config> > >& proj,
    std::vector<std::vector<proj_func*> > & projF,
    std::vector<std::vector<std::vector<int> > >& Po,
-   std::vector<aggdistrib> &P,
       std::vector<aggpayoff>& payoffs);
 
 
@@ -122,17 +151,20 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
       for (size_t i=0;i<projectionTypes.size();++i){
         delete projectionTypes[i];
       }
+      for (size_t i=0;i<keyLayouts.size();++i){
+        delete keyLayouts[i];
+      }
   }
 
 
-  inline int getNumPlayers() {return numPlayers;}
+  inline int getNumPlayers() const {return numPlayers;}
   inline int getNumActions() {return totalActions;}
   inline int getNumActions(int i){return actions[i];}  
   inline int getMaxActions() {return maxActions;}
   inline int firstAction(int i) {return strategyOffset[i];}
   inline int lastAction(int i) {return strategyOffset[i+1];}
 
-  inline int getNumActionNodes() {return numActionNodes;}
+  inline int getNumActionNodes() const {return numActionNodes;}
   inline int getNumFunctionNodes() {return numPNodes;}
   //inline int getNumUniqueActionSets(){return uniqueActionSets.size();}
   inline int getNumKSymActions(){return numKSymActions;}
@@ -157,11 +189,39 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   }
 
 
-  //exp. payoff under mixed strat profile
-  AggNumber getMixedPayoff(int player, StrategyProfile &s);
-  void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s);
-  AggNumber getV (int player, int action,const StrategyProfile &s);
-  AggNumber getJ(int player,int action, int player2,int action2,StrategyProfile &s);
+  //exp. payoff under mixed strat profile.
+  //The versions without a Workspace use one owned by the game, and so
+  //must not be called concurrently.
+  AggNumber getMixedPayoff(Workspace &w, int player, StrategyProfile &s);
+  void getPayoffVector(Workspace &w, AggNumberVector &dest, int player,const StrategyProfile &s);
+  AggNumber getV (Workspace &w, int player, int action,const StrategyProfile &s);
+  AggNumber getJ(Workspace &w, int player,int action, int player2,int action2,StrategyProfile &s);
+
+  //derivatives of player's exp. payoff w.r.t. the probability of each
+  //action, indexed as s; if jac is not NULL, also the second derivatives,
+  //with (*jac)[i*getNumActions()+j] for actions i of player and all
+  //actions j.  The rows for the other players' actions are zero.
+  //These are computed together from the distributions induced by all
+  //players but one or two, rather than entry by entry.
+  void getPayoffDerivs(Workspace &w, int player, const StrategyProfile &s,
+                       AggNumberVector &dest, AggNumberVector *jac=NULL);
+
+  AggNumber getMixedPayoff(int player, StrategyProfile &s){
+    return getMixedPayoff(workspace, player, s);
+  }
+  void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s){
+    getPayoffVector(workspace, dest, player, s);
+  }
+  AggNumber getV (int player, int action,const StrategyProfile &s){
+    return getV(workspace, player, action, s);
+  }
+  AggNumber getJ(int player,int action, int player2,int action2,StrategyProfile &s){
+    return getJ(workspace, player, action, player2, action2, s);
+  }
+  void getPayoffDerivs(int player, const StrategyProfile &s,
+                       AggNumberVector &dest, AggNumberVector *jac=NULL){
+    getPayoffDerivs(workspace, player, s, dest, jac);
+  }
 
 
   AggNumber getPurePayoff(int player, int *s);
@@ -176,14 +236,39 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
     }
     return true;
   }
-  AggNumber getSymMixedPayoff( StrategyProfile &s);
-  AggNumber getSymMixedPayoff(int actnode, StrategyProfile &s);
-  void getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s);
-  AggNumber getKSymMixedPayoff( int playerClass,std::vector<StrategyProfile> &s);
-  AggNumber getKSymMixedPayoff( int playerClass,StrategyProfile &s);
-  AggNumber getKSymMixedPayoff(int playerClass, int act, std::vector<StrategyProfile> &s);
-  AggNumber getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1);
-  void getKSymPayoffVector(AggNumberVector& dest, int playerClass, StrategyProfile &s);
+  AggNumber getSymMixedPayoff(Workspace &w, StrategyProfile &s);
+  AggNumber getSymMixedPayoff(Workspace &w, int actnode, StrategyProfile &s);
+  void getSymPayoffVector(Workspace &w, AggNumberVector& dest, StrategyProfile &s);
+  AggNumber getKSymMixedPayoff(Workspace &w, int playerClass,std::vector<StrategyProfile> &s);
+  AggNumber getKSymMixedPayoff(Workspace &w, int playerClass,StrategyProfile &s);
+  AggNumber getKSymMixedPayoff(Workspace &w, int playerClass, int act, std::vector<StrategyProfile> &s);
+  AggNumber getKSymMixedPayoff(Workspace &w, const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1);
+  void getKSymPayoffVector(Workspace &w, AggNumberVector& dest, int playerClass, StrategyProfile &s);
+
+  AggNumber getSymMixedPayoff( StrategyProfile &s){
+    return getSymMixedPayoff(workspace, s);
+  }
+  AggNumber getSymMixedPayoff(int actnode, StrategyProfile &s){
+    return getSymMixedPayoff(workspace, actnode, s);
+  }
+  void getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s){
+    getSymPayoffVector(workspace, dest, s);
+  }
+  AggNumber getKSymMixedPayoff( int playerClass,std::vector<StrategyProfile> &s){
+    return getKSymMixedPayoff(workspace, playerClass, s);
+  }
+  AggNumber getKSymMixedPayoff( int playerClass,StrategyProfile &s){
+    return getKSymMixedPayoff(workspace, playerClass, s);
+  }
+  AggNumber getKSymMixedPayoff(int playerClass, int act, std::vector<StrategyProfile> &s){
+    return getKSymMixedPayoff(workspace, playerClass, act, s);
+  }
+  AggNumber getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1){
+    return getKSymMixedPayoff(workspace, s, pClass1, act1, pClass2, act2);
+  }
+  void getKSymPayoffVector(AggNumberVector& dest, int playerClass, StrategyProfile &s){
+    getKSymPayoffVector(workspace, dest, playerClass, s);
+  }
 
 
 
@@ -206,8 +291,8 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   const std::vector<int>& getActionSet(int player){return actionSets.at(player);}
   const aggpayoff& getPayoffMap(int node){return payoffs.at(node);}
 
-  AggNumber getMaxPayoff();
-  AggNumber getMinPayoff();
+  AggNumber getMaxPayoff() const {return maxPayoff;}
+  AggNumber getMinPayoff() const {return minPayoff;}
 
 
 
@@ -236,6 +321,11 @@ private:
   //payoff function for each action node \in S
   std::vector<aggpayoff> payoffs;
 
+  //foreach s \in S, the bounds on the configurations of s, under which
+  //distributions over them are looked up without walking the tries;
+  //NULL if the configurations cannot be numbered
+  std::vector<key_layout*> keyLayouts;
+
   //auxillary data strucutres
 
   //originally:
@@ -248,10 +338,6 @@ private:
   // the contribution of s' to D^(s)
   //std::vector<std::vector<config> > projection;
 
-  //foreach s \in S, foreach i \in N, the projected mixed strat
-  //which is a prob distribution over the set of 'contributions'
-  std::vector< std::vector<aggdistrib > > projectedStrat;
-
   // foreach s in S, i in N, the full set of projected actions.
   std::vector<std::vector<aggdistrib> >fullProjectedStrat;
 
@@ -262,24 +348,12 @@ private:
   // in which we apply the DP algorithm
   std::vector< std::vector< std::vector<int> > > Porder;
 
-  //when computing the induced distribution via ComputeP():
-  //foreach k<= n-1,  
-  //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
-
-  //when computing the partial distributions for the payoff jacobian:
-  //  foreach  j \in N,
-  // the partial distribution induced by all agents except j. 
-  std::vector<aggdistrib>  Pr;
-
   //foreach s in S, whether s's neighbors are all action nodes
   std::vector<bool> isPure;
 
   //foreach s in S, j in N, the index of s in j's action set, or -1 if N/A
   std::vector<std::vector<int> > node2Action;
 
-  //cache of jacobian entries.
-  trie_map<AggNumber> cache;
-
   //the unique action sets
   std::vector<ActionSet> uniqueActionSets;
 
@@ -295,6 +369,13 @@ private:
   //strategyOffset for kSymmetric strategy profile
   std::vector<int> kSymStrategyOffset;
 
+  //the extreme payoffs over all action nodes
+  AggNumber maxPayoff, minPayoff;
+
+  //scratch space for the versions of the payoff computations
+  //that do not take a Workspace
+  Workspace workspace;
+
 
   //input functor 
   struct input : public std::unary_function<aggpayoff::iterator , void>{
@@ -336,17 +417,18 @@ private:
 
 
   //private methods:
-  void computeP(int player, int act, int player2=-1,int act2=-1);
-  void doProjection(int Node,const StrategyProfile& s){
-	  doProjection (Node, &(const_cast<StrategyProfile &>(s)[0]));
+  void computeP(Workspace &w, int player, int act, int player2=-1,int act2=-1);
+  int computePartialP(Workspace &w, int player, int act, int player2);
+  void doProjection(Workspace &w, int Node,const StrategyProfile& s){
+	  doProjection (w, Node, &(const_cast<StrategyProfile &>(s)[0]));
   }
-  void doProjection(int Node, int player, const StrategyProfile& s){
-	  doProjection(Node,player, &(const_cast<StrategyProfile &>(s)[firstAction(player)]));
+  void doProjection(Workspace &w, int Node, int player, const StrategyProfile& s){
+	  doProjection(w, Node,player, &(const_cast<StrategyProfile &>(s)[firstAction(player)]));
   }
-  void doProjection(int Node, AggNumber* s);
-  void doProjection(int Node, int player, AggNumber* s);
+  void doProjection(Workspace &w, int Node, AggNumber* s);
+  void doProjection(Workspace &w, int Node, int player, AggNumber* s);
 
-  void getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2=-1,int act2=-1);
+  void getSymConfigProb(Workspace &w, int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2=-1,int act2=-1);
 };
 
 
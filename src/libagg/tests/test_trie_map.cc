@@ -0,0 +1,216 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libagg/tests/test_trie_map.cc
+// Tests of looking up configurations by mixed-radix number
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "libagg/proj_func.h"
+#include "libagg/trie_map.h"
+#include "libgambit/tests/testing.h"
+
+namespace {
+
+typedef trie_map<double> distrib;
+
+//
+// A key within the bounds, or, with the given probability, one with an
+// entry beyond them, which makes the map fall back to the trie.
+//
+std::vector<int> RandomKey(const std::vector<int> &p_radix, double p_outside)
+{
+  std::vector<int> key(p_radix.size());
+  for (size_t i = 0; i < key.size(); i++) {
+    key[i] = std::rand() % p_radix[i];
+  }
+  if ((double) std::rand() / RAND_MAX < p_outside) {
+    key[std::rand() % key.size()] += p_radix[0] + p_radix[1];
+  }
+  return key;
+}
+
+/// Checks that the maps hold the same entries, in the same order
+void CheckSameEntries(const distrib &p_map, const distrib &p_trie)
+{
+  GAMBIT_CHECK(p_map.size() == p_trie.size());
+  distrib::const_iterator p = p_map.begin(), q = p_trie.begin();
+  for (; p != p_map.end() && q != p_trie.end(); ++p, ++q) {
+    GAMBIT_CHECK(p->first == q->first);
+    GAMBIT_CHECK(p->second == q->second);
+  }
+}
+
+/// Checks that the maps find the same keys, within and beyond the bounds
+void CheckSameLookups(distrib &p_map, distrib &p_trie,
+		      const std::vector<int> &p_radix)
+{
+  std::vector<int> key(p_radix.size(), 0);
+  while (true) {
+    distrib::iterator p = p_map.findExact(key), q = p_trie.findExact(key);
+    GAMBIT_CHECK((p == p_map.end()) == (q == p_trie.end()));
+    if (p != p_map.end() && q != p_trie.end()) {
+      GAMBIT_CHECK(p->first == key && p->second == q->second);
+    }
+    GAMBIT_CHECK(p_map.count(key) == p_trie.count(key));
+    distrib::iterator r = p_map.find(key);
+    GAMBIT_CHECK(r == p_map.end() || r->first == key);
+
+    // Count through the keys with entries up to twice the bounds
+    size_t i = 0;
+    while (i < key.size() && ++key[i] == 2 * p_radix[i])  key[i++] = 0;
+    if (i == key.size())  break;
+  }
+}
+
+/// Checks that the maps agree as distributions, up to rounding
+void CheckSameDistribution(const distrib &p_map, const distrib &p_expected)
+{
+  std::map<std::vector<int>, double> expected;
+  for (distrib::const_iterator p = p_expected.begin();
+       p != p_expected.end(); ++p) {
+    expected[p->first] = p->second;
+  }
+  size_t count = 0;
+  for (distrib::const_iterator p = p_map.begin(); p != p_map.end(); ++p) {
+    if (std::fabs(p->second) <= 1.0e-12)  continue;
+    count++;
+    GAMBIT_CHECK(expected.count(p->first) == 1 &&
+		 std::fabs(expected[p->first] - p->second) <= 1.0e-12);
+  }
+  GAMBIT_CHECK(count == expected.size());
+}
+
+//
+// Fills maps under no layout, a dense layout, and a hashed layout with
+// the same sequence of insertions and additions, and checks that they
+// agree on the entries and on lookups.  The maps are then reset and
+// filled again, as the workspaces of a game are between evaluations.
+//
+void TestLayouts(const std::vector<int> &p_radix, double p_outside)
+{
+  key_layout dense(p_radix, true), hashed(p_radix, false);
+  distrib trie, denseMap, hashedMap;
+
+  for (int round = 0; round < 3; round++) {
+    // An insertion outside the bounds makes the maps fall back to the
+    // trie, so the layouts are set again for each round
+    trie.reset();
+    denseMap.reset();
+    hashedMap.reset();
+    denseMap.setLayout(&dense);
+    hashedMap.setLayout(&hashed);
+    int count = 1 + std::rand() % (2 * (int) dense.size);
+    for (int i = 0; i < count; i++) {
+      std::pair<std::vector<int>, double> entry(RandomKey(p_radix, p_outside),
+						1 + std::rand() % 8);
+      trie += entry;
+      denseMap += entry;
+      hashedMap += entry;
+    }
+    CheckSameEntries(denseMap, trie);
+    CheckSameEntries(hashedMap, trie);
+    CheckSameLookups(denseMap, trie, p_radix);
+    CheckSameLookups(hashedMap, trie, p_radix);
+
+    // A copy takes the layout of the original, with the entries in the
+    // reverse order
+    distrib copy(hashedMap);
+    CheckSameDistribution(copy, trie);
+    CheckSameLookups(copy, trie, p_radix);
+  }
+}
+
+//
+// Multiplies distributions with configurations combined by summing,
+// under each layout, and checks the products agree, and that dividing
+// a product by one of its factors gives back the other.
+//
+void TestProducts(const std::vector<int> &p_radix)
+{
+  size_t keylen = p_radix.size();
+  proj_func_SUM sum;
+  std::vector<proj_func *> f(keylen, &sum);
+
+  // The products of the factors, and of each factor with a unit step,
+  // stay within the bounds
+  std::vector<int> bound(keylen);
+  for (size_t i = 0; i < keylen; i++)  bound[i] = p_radix[i] / 2;
+  key_layout dense(p_radix, true), hashed(p_radix, false);
+
+  distrib factor1, factor2;
+  for (int i = 0; i < 6; i++) {
+    factor1 += std::make_pair(RandomKey(bound, 0.0), 0.1 * (1 + std::rand() % 5));
+    factor2 += std::make_pair(RandomKey(bound, 0.0), 0.1 * (1 + std::rand() % 5));
+  }
+
+  distrib trie, denseMap, hashedMap;
+  trie.multiply(factor1, factor2, keylen, f);
+  denseMap.setLayout(&dense);
+  denseMap.multiply(factor1, factor2, keylen, f);
+  hashedMap.setLayout(&hashed);
+  hashedMap.multiply(factor1, factor2, keylen, f);
+  CheckSameEntries(denseMap, trie);
+  CheckSameEntries(hashedMap, trie);
+  CheckSameLookups(denseMap, trie, p_radix);
+  CheckSameLookups(hashedMap, trie, p_radix);
+
+  distrib square, denseSquare;
+  trie.square(square, keylen, f);
+  denseSquare.setLayout(&dense);
+  denseMap.square(denseSquare, keylen, f);
+  CheckSameEntries(denseSquare, square);
+
+  // Multiplying by the distribution of a unit step along each coordinate,
+  // as a single strategy adds to a configuration, and dividing by it again
+  std::vector<double> step(keylen);
+  distrib steps;
+  for (size_t i = 0; i < keylen; i++) {
+    step[i] = (double) (keylen - i) / (double) (keylen * (keylen + 1) / 2);
+    std::vector<int> unit(keylen, 0);
+    unit[i] = 1;
+    steps += std::make_pair(unit, step[i]);
+  }
+  distrib stepped, denseStepped;
+  stepped.multiply(factor1, steps, keylen, f);
+  denseStepped.setLayout(&dense);
+  denseStepped.multiply(factor1, steps, keylen, f);
+  stepped /= step;
+  denseStepped /= step;
+  CheckSameDistribution(stepped, factor1);
+  CheckSameDistribution(denseStepped, factor1);
+}
+
+}  // end anonymous namespace
+
+int main(int, char **)
+{
+  std::srand(1);
+  int radixes[][3] = { { 2, 2, 2 }, { 3, 4, 2 }, { 5, 2, 6 }, { 8, 8, 8 } };
+  for (int i = 0; i < 4; i++) {
+    std::vector<int> radix(radixes[i], radixes[i] + 3);
+    TestLayouts(radix, 0.0);
+    TestLayouts(radix, 0.05);
+    TestProducts(radix);
+  }
+  return TestResult();
+}
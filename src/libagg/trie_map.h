@@ -28,6 +28,7 @@
 //WARNING: traversal using the iterators is in the reverse order of insertion.
 
 #include <math.h>
+#include <algorithm>
 #include <list>
 #include <iterator>
 
@@ -46,6 +47,32 @@ ostream& operator<< (ostream& s, const trie_map<V>& t);
 
 
 
+//key_layout: bounds on the keys of a trie_map.  Under a layout, each
+//key is numbered in mixed radix and looked up by its number, in a dense
+//array when the keys within the bounds are few, or in an open-addressing
+//hash table otherwise, instead of by walking the trie.
+struct key_layout
+{
+  std::vector<int> radix;  //bounds: each key[i] is in [0, radix[i])
+  size_t size;             //number of keys within the bounds
+  bool dense;
+
+  key_layout(const std::vector<int>& r, bool d):radix(r),size(1),dense(d){
+    for (size_t i=0;i<radix.size();++i) size*=radix[i];
+  }
+
+  //number of the key k; false if k is not within the bounds
+  inline bool code(const std::vector<int>& k, size_t& c) const{
+    if (k.size()!=radix.size()) return false;
+    c=0;
+    for (size_t i=0;i<k.size();++i){
+      if (k[i]<0||k[i]>=radix[i]) return false;
+      c=c*radix[i]+k[i];
+    }
+    return true;
+  }
+};
+
 template <class V>
 struct TrieNode
 {
@@ -89,8 +116,10 @@ public:
   friend class agg;
 
   //constructors
-  trie_map():initBranches(1),root(new TrieNode<V>(1,data.end())){}
-  trie_map(int branches):initBranches(branches),root(new TrieNode<V>(branches,data.end())){}
+  trie_map():initBranches(1),root(new TrieNode<V>(1,data.end())),
+    layout(NULL),stamp(1),mask(0),numSlotted(0){}
+  trie_map(int branches):initBranches(branches),root(new TrieNode<V>(branches,data.end())),
+    layout(NULL),stamp(1),mask(0),numSlotted(0){}
 
 
   //copy constructor
@@ -136,14 +165,23 @@ public:
   //exact matching
   inline iterator findExact (const key_type& k);
 
+  //look up keys through the given layout, or through the trie if NULL.
+  //the layout is kept by reset(); the results of multiply(), square()
+  //and assignment take the layout of their first operand that has one,
+  //and otherwise keep their own.  keys outside the bounds are inserted
+  //by falling back to the trie.
+  void setLayout(const key_layout *l);
+
   //clear the tree strucutre as well as data
   inline void clear(){
+	if (layout) newStamp();
+	numSlotted=0;
 	deleteNodes(root);
 	root=new TrieNode<V> (initBranches, data.end()); 
 #ifdef AGGDEBUG
 	iterator endp = data.end();
 #endif
-	data.clear();
+	spare.splice(spare.end(),data);
 #ifdef AGGDEBUG
 	if(endp != end()) {std::cerr<<"Error: end() changed"<<endl; exit(1);}
 #endif
@@ -173,12 +211,15 @@ public:
       leaves.back()->val=data.end();
       leaves.pop_back();
     }
-    data.clear();
+    spare.splice(spare.end(),data);
+    if (layout) newStamp();
+    numSlotted=0;
   }
 
   //number of elements with key exactly k.
   // returns 1 or 0 
   inline size_type count(const key_type& k) {
+    if (layout) return (findExact(k)!=data.end());
     size_t i=0;
     TrieNode<V>* ptr=root;
     for (;i<k.size()&&k[i]<(int)ptr->children.size()&&  ptr->children[k[i]];ptr=ptr->children[k[i++]]) ;
@@ -189,6 +230,7 @@ public:
   //in order traversal
   template <class UnaryFunction>
   inline void in_order(UnaryFunction f, bool debug=false){
+	setLayout(NULL);
 	in_order_subtree(f, root, debug);
   }
   inline void print_in_order (){in_order(print_helper(end()),true);}
@@ -197,16 +239,16 @@ public:
   void multiply (const trie_map<V>& t1,const trie_map<V>& t2,size_t keylen,
 	 std::vector<proj_func*>& f)
   {
-    static size_t i;
-    static std::pair<std::vector<int>, V> v;
+    std::pair<std::vector<int>, V> v;
     const_iterator p1,p2;
     //assert(this!=&t1 && this != &t2);
     v.first.resize(keylen);
     reset();
+    if (t1.layout||t2.layout) setLayout((t1.layout)?t1.layout:t2.layout);
     for (p1=t1.begin(); p1!=t1.end(); ++p1)if((*p1).second>(V)0){
       for(p2=t2.begin(); p2!=t2.end(); ++p2)if((*p2).second>(V)0){
 	//assert((*p1).first.size()==keylen&& (*p2).first.size()==keylen);
-	for (i=0;i<keylen;++i){
+	for (size_t i=0;i<keylen;++i){
 	  v.first[i]= (*(f[i])) ((*p1).first[i], (*p2).first[i]);
 	}
 	v.second = (V)((*p1).second * (*p2).second);
@@ -222,7 +264,7 @@ public:
   void multiply_smart (const trie_map<V>& P_k_minus_1,const trie_map<V>& projectedStrat,size_t keylen,
                         std::vector<proj_func*>& f)
         {
-                static std::pair<std::vector<int>, V> v;
+                std::pair<std::vector<int>, V> v;
                 v.first.resize(keylen);
                 reset();
 
@@ -277,10 +319,11 @@ public:
 
   //squaring
   void square(trie_map<V>& dest, size_t keylen, std::vector<proj_func*>& f) const{
-    static std::pair<std::vector<int>, V> v;
+    std::pair<std::vector<int>, V> v;
     v.first.resize(keylen);
     //assert(this!=&dest);
     dest.reset();
+    if (layout) dest.setLayout(layout);
     for (const_iterator p1=begin(); p1!=end(); ++p1)if((*p1).second>(V)0){
       for(const_iterator p2=p1; p2!=end(); ++p2)if((*p2).second>(V)0){
 	  //assert((*p1).first.size()==keylen&& (*p2).first.size()==keylen);
@@ -296,14 +339,13 @@ public:
 
   //squaring in-place
   void square(size_t keylen, std::vector<proj_func*>& f){
-    static typename std::list<typename trie_map<V>::value_type>::iterator p1,p2;
-    static std::pair<std::vector<int>, V> v;
+    typename std::list<typename trie_map<V>::value_type>::iterator p1,p2;
+    std::pair<std::vector<int>, V> v;
     v.first.resize(keylen);
     std::list<typename trie_map<V>::value_type> data2;
-    //data.swap(data2);
-    data2=data;
+    data2.splice(data2.end(),data);
     reset();
-    for(p1=data2.begin();p1!=end();++p1)if((*p1).second>(V)0){
+    for(p1=data2.begin();p1!=data2.end();++p1)if((*p1).second>(V)0){
       for(p2=p1; p2!=data2.end(); ++p2)if((*p2).second>(V)0){
 	  //assert((*p1).first.size()==keylen&& (*p2).first.size()==keylen);
         for (size_t i=0;i<keylen;++i){
@@ -314,6 +356,7 @@ public:
         (*this) += v;
       }//end for(p2
     }//end for(p1
+    spare.splice(spare.end(),data2);
   }
 
   //take power of self using repeated squaring. result stored in dest.
@@ -388,27 +431,27 @@ public:
   { 
     V result(init);
     V th(THRESH);
-    static iterator p2;
+    iterator p2;
+    key_type y(keylen);
     //V s(-1);
     for (const_iterator p=begin(); p!=end();++p)if((*p).second>(V)0){
-      value_type y= *p;
-      //assert(y.first.size()==keylen);
+      //assert(p->first.size()==keylen);
       for (size_t i=0; i<keylen;++i){
-	y.first[i] = (*(f[i])) (y.first[i],x[i]); 
+	y[i] = (*(f[i])) (p->first[i],x[i]); 
       }
-      //s += y.second;
+      //s += p->second;
 
-      p2 = other.find(y.first);
+      p2 = other.find(y);
       //assert(p2!= other.end());
       if (p2==other.end()){
-        if(y.second>th){
+        if(p->second>th){
 	  cout<<"inner_prod WARNING: discarding [";
-	  copy(y.first.begin(),y.first.end(), ostream_iterator<int>(cout," "));
-	  cout<<"] "<<y.second<<endl;
+	  copy(y.begin(),y.end(), ostream_iterator<int>(cout," "));
+	  cout<<"] "<<p->second<<endl;
         }
       }
       else{
-        result += y.second  * (*p2).second;
+        result += p->second  * (*p2).second;
       }
     }
 
@@ -426,11 +469,26 @@ public:
 private:
   //member variables:
   std::list<value_type> data;
+  std::list<value_type> spare;  //nodes of data kept for reuse
   size_type initBranches; //default branching factor
   TrieNode<V> *root;
 
   std::vector<TrieNode<V>*> leaves;
 
+  //lookup through a key_layout.  while there is a layout, the trie
+  //holds no values.  slots whose stamp differs from the current one
+  //are empty, so that reset() need not visit them.
+  struct slot {
+    unsigned stamp;
+    iterator val;
+    slot():stamp(0) {}
+  };
+  const key_layout *layout;
+  std::vector<slot> slots;
+  unsigned stamp;
+  size_t mask;            //hashed layouts: slots[0..mask] is the table
+  size_type numSlotted;   //number of values in the table
+
   static const double  THRESH;
   
   
@@ -450,6 +508,40 @@ private:
   //private methods:
   //div: helper for operator/=()
   void  div(const std::vector<V>& denom, TrieNode<V>* n, int current, int pivot);
+  //the same under a dense layout
+  void  divDense(const std::vector<V>& denom, int pivot);
+  void  divAdd(const std::vector<int>& conf, V y, V pivotDenom);
+
+  //insert x at the front of data, reusing a spare node if there is one
+  inline iterator push(const value_type& x){
+    if (spare.empty()) return data.insert(data.begin(),x);
+    data.splice(data.begin(),spare,spare.begin());
+    *data.begin()=x;
+    return data.begin();
+  }
+
+  //the slot of key k with number c: either the one holding it, or the
+  //empty one where it belongs
+  inline slot& locate(size_t c, const key_type& k){
+    if (layout->dense) return slots[c];
+    c^=c>>16; c*=0x45d9f3b; c^=c>>16;
+    for (c&=mask; slots[c].stamp==stamp && slots[c].val->first!=k; c=(c+1)&mask) ;
+    return slots[c];
+  }
+
+  inline void newStamp(){
+    if (++stamp==0){
+      for (size_t i=0;i<slots.size();++i) slots[i].stamp=0;
+      stamp=1;
+    }
+  }
+
+  //enter all values in the slots of the layout, or fall back to the
+  //trie if some key is out of bounds
+  void index();
+
+  //enter all values in the trie
+  void rebuildTrie();
 
 
 
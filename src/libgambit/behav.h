@@ -27,6 +27,8 @@
 
 namespace Gambit {
 
+class GameTreeEvaluationView;
+
 ///
 /// MixedBehaviorProfile<T> implements a randomized behavior profile on
 /// an extensive game.
@@ -36,6 +38,10 @@ protected:
   BehaviorSupportProfile m_support;
 
   mutable bool m_cacheValid;
+  // Information sets whose action probabilities have been changed since
+  // the cached data were last computed.  While the cache is otherwise
+  // valid, only the parts of the tree affected by these are recomputed.
+  mutable List<GameInfoset> m_changedInfosets;
 
   // structures for storing cached data: nodes
   mutable Vector<T> m_realizProbs, m_beliefs, m_nvals, m_bvals;
@@ -48,6 +54,10 @@ protected:
   mutable DVector<T> m_actionValues;   // aka conditional payoffs
   mutable DVector<T> m_gripe;
 
+  // the probabilities of all actions, including chance's, indexed as in
+  // the evaluation view of the tree
+  mutable Array<T> m_branchProbs;
+
   const T &ActionValue(const GameAction &act) const 
     { return m_actionValues(act->GetInfoset()->GetPlayer()->GetNumber(),
 			    act->GetInfoset()->GetNumber(),
@@ -61,9 +71,17 @@ protected:
   //@{
   void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
   
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  void GetBranchProbs(const GameTreeEvaluationView &, Array<T> &) const;
+  void ComputeSolutionDataPass1(const GameTreeEvaluationView &,
+				const Array<T> &) const;
+  void ComputeSolutionDataPass2(const GameTreeEvaluationView &,
+				const Array<T> &) const;
+  void ComputeNodeValue(const GameTreeEvaluationView &, 
+			const Array<T> &, int) const;
+  void ComputeInfosetData(const GameTreeEvaluationView &,
+			  const Array<T> &, int) const;
   void ComputeSolutionData(void) const;
+  void UpdateSolutionData(void) const;
   //@}
 
   /// @name Converting mixed strategies to behavior
@@ -122,7 +140,7 @@ public:
   const T &operator()(int a, int b, int c) const
     { return DVector<T>::operator()(a, b, c); }
   T &operator()(int a, int b, int c) 
-    { Invalidate();  return DVector<T>::operator()(a, b, c); }
+    { InvalidateInfoset(a, b);  return DVector<T>::operator()(a, b, c); }
   const T &operator[](int a) const
     { return Array<T>::operator[](a); }
   T &operator[](int a)
@@ -142,6 +160,9 @@ public:
   //@{
   /// Force recomputation of stored quantities
   void Invalidate(void) const { m_cacheValid = false; }
+  /// Force recomputation of the quantities affected by a change at
+  /// information set 'iset' of player 'pl'
+  void InvalidateInfoset(int pl, int iset) const;
   /// Set the profile to the centroid
   void SetCentroid(void);
   /// Set the behavior at any undefined information set to the centroid
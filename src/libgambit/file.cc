@@ -22,11 +22,23 @@
 
 #include <cstdlib>
 #include <cctype>
+#include <algorithm>
 #include <iostream>
+#include <fstream>
 #include <sstream>
+#include <vector>
 #include <map>
 
 #include "libgambit.h"
+#include "gametable.h"
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // HAVE_SYS_MMAN_H && HAVE_MMAP
 
 namespace {
 // This anonymous namespace encapsulates the file-parsing code
@@ -43,22 +55,34 @@ typedef enum {
 //! including the nonsignificance of whitespace and the possibility of
 //! escaped-quotes within text labels.
 //!
+//! Characters are taken directly from a range in memory.  When reading
+//! from a stream, the range is a buffer which is refilled in blocks as
+//! it is exhausted, so the file is never held in memory as a whole.
+//!
 class GameParserState {
 private:
-  std::istream &m_file;
+  std::istream *m_file;
+  std::vector<char> m_buffer;
+  const char *m_current, *m_end;
+  bool m_eof;
 
   int m_currentLine;
   int m_currentColumn;
   GameFileToken m_lastToken;
   std::string m_lastText;
 
+  bool Refill(void);
   void ReadChar(char& c);
   void UnreadChar(void);
   void IncreaseLine(void);
 
 public:
-  GameParserState(std::istream &p_file) :
-    m_file(p_file), m_currentLine(1), m_currentColumn(1) { }
+  /// Parse the contents of the stream
+  GameParserState(std::istream &p_file);
+  /// Parse the characters in the range [p_begin, p_end)
+  GameParserState(const char *p_begin, const char *p_end) :
+    m_file(0), m_current(p_begin), m_end(p_end), m_eof(false),
+    m_currentLine(1), m_currentColumn(1) { }
 
   GameFileToken GetNextToken(void);
   GameFileToken GetCurrentToken(void) const { return m_lastToken; }
@@ -66,17 +90,60 @@ public:
   int GetCurrentColumn(void) const { return m_currentColumn; }
   std::string CreateLineMsg(const std::string &msg);
   const std::string &GetLastText(void) const { return m_lastText; }
+
+  /// Returns true if the input is a binary savefile.  This must be
+  /// called before anything is read, so the tag is within the first block.
+  bool IsBinaryFile(void);
+  /// Skips over whitespace, and returns the next character without
+  /// reading it, or zero at the end of the input
+  char PeekSignificantChar(void);
+  /// Returns all characters not yet read
+  std::string GetRemainder(void);
 };
 
+GameParserState::GameParserState(std::istream &p_file)
+  : m_file(&p_file), m_buffer(65536), m_eof(false),
+    m_currentLine(1), m_currentColumn(1)
+{
+  // The first position of the buffer is reserved for keeping the last
+  // character of the previous block, so it can always be unread
+  m_current = m_end = &m_buffer[1];
+}
+
+bool GameParserState::Refill(void)
+{
+  if (!m_file || !m_file->good()) {
+    return false;
+  }
+  if (m_end > &m_buffer[1]) {
+    m_buffer[0] = *(m_end - 1);
+  }
+  m_file->read(&m_buffer[1], m_buffer.size() - 1);
+  m_current = &m_buffer[1];
+  m_end = m_current + m_file->gcount();
+  return (m_current < m_end);
+}
+
 void GameParserState::ReadChar(char& c)
 {
-  m_file.get(c);
+  if (m_current < m_end || Refill()) {
+    c = *(m_current++);
+  }
+  else {
+    m_eof = true;
+    c = '\0';
+  }
   m_currentColumn++;
 }
 
 void GameParserState::UnreadChar(void)
 {
-  m_file.unget();
+  if (m_eof) {
+    m_eof = false;
+  }
+  else {
+    m_current--;
+  }
   m_currentColumn--;
 }
 
@@ -86,16 +153,50 @@ void GameParserState::IncreaseLine(void){
   m_currentColumn = 1;
 }
 
+bool GameParserState::IsBinaryFile(void)
+{
+  if (m_current == m_end) {
+    Refill();
+  }
+  return GameTableRep::IsBinaryFile(m_current, m_end);
+}
+
+char GameParserState::PeekSignificantChar(void)
+{
+  while (m_current < m_end || Refill()) {
+    if (!isspace(*m_current)) {
+      return *m_current;
+    }
+    m_currentColumn++;
+    if (*(m_current++) == '\n') {
+      IncreaseLine();
+    }
+  }
+  return 0;
+}
+
+std::string GameParserState::GetRemainder(void)
+{
+  std::string text(m_current, m_end);
+  m_current = m_end;
+  if (m_file) {
+    std::ostringstream rest;
+    rest << m_file->rdbuf();
+    text += rest.str();
+  }
+  return text;
+}
+
 GameFileToken GameParserState::GetNextToken(void)
 {
   char c = ' ';
-  if (m_file.eof()) {
+  if (m_eof) {
     return (m_lastToken = TOKEN_EOF);
   }
 
   while (isspace(c)) {
     ReadChar(c);
-    if (!m_file.good()) {
+    if (m_eof) {
       return (m_lastToken = TOKEN_EOF);
     }
     else if (c == '\n') {
@@ -117,12 +218,12 @@ GameFileToken GameParserState::GetNextToken(void)
     buf += c;
     ReadChar(c);
 
-    while (!m_file.eof() && m_file.good() && isdigit(c)) {
+    while (!m_eof && isdigit(c)) {
       buf += c;
       ReadChar(c);
     }
 
-    if (m_file.eof() || !m_file.good()) {
+    if (m_eof) {
       m_lastText = buf;
       return (m_lastToken = TOKEN_NUMBER);
     }
@@ -221,7 +322,7 @@ GameFileToken GameParserState::GetNextToken(void)
 
       ReadChar(a);
       while  (a != '\"' || lastslash)  {
-	if (m_file.eof() || !m_file.good())  {
+	if (m_eof)  {
 	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
 	}
         if (lastslash && a == '"') {
@@ -242,7 +343,7 @@ GameFileToken GameParserState::GetNextToken(void)
       do  {
       	m_lastText += a;
         ReadChar(a);
-	if (m_file.eof() || !m_file.good())  {
+	if (m_eof)  {
 	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
 	}
         if (a == '\n') {
@@ -255,7 +356,7 @@ GameFileToken GameParserState::GetNextToken(void)
   }
 
   m_lastText = "";
-  while (!isspace(c) && !m_file.eof()) {
+  while (!isspace(c) && !m_eof) {
     m_lastText += c;
     ReadChar(c);
   }
@@ -1045,42 +1146,70 @@ Game GameXMLSavefile::GetGame(void) const
 }
 
 //=========================================================================
-//    ReadGame: Global visible function to read an .efg or .nfg file
+//    ReadGame: Global visible function to read a game savefile
 //=========================================================================
 
-Game ReadGame(std::istream &p_file) throw (InvalidFileException)
+namespace {
+
+//
+// The contents of a binary savefile read from a stream, held in a
+// buffer of doubles so the payoffs are suitably aligned.
+//
+class BufferedFile : public GameTableStorage {
+private:
+  std::vector<double> m_buffer;
+  size_t m_length;
+
+public:
+  BufferedFile(const std::string &p_contents)
+    : m_buffer(p_contents.length() / sizeof(double) + 1),
+      m_length(p_contents.length())
+  { p_contents.copy(reinterpret_cast<char *>(&m_buffer[0]), m_length); }
+  virtual ~BufferedFile() { }
+
+  virtual const char *Begin(void) const
+  { return reinterpret_cast<const char *>(&m_buffer[0]); }
+  virtual const char *End(void) const { return Begin() + m_length; }
+};
+
+//
+// Reads a game from a parser which has not yet read anything.  Binary
+// savefiles and XML documents are recognized by their leading tags,
+// and the other formats by the keyword at the start of the file.
+//
+Game ParseGame(GameParserState &p_parser)
 {
-  std::stringstream buffer;
-  buffer << p_file.rdbuf();
-  try {
-    GameXMLSavefile doc(buffer.str());
-    return doc.GetGame();
+  if (p_parser.IsBinaryFile()) {
+    return GameTableRep::ReadBinaryFile(new BufferedFile(p_parser.GetRemainder()));
   }
-  catch (InvalidFileException) {
-    buffer.seekg(0, std::ios::beg);
+
+  if (p_parser.PeekSignificantChar() == '<') {
+    GameXMLSavefile doc(p_parser.GetRemainder());
+    return doc.GetGame();
   }
 
-  GameParserState parser(buffer);
   try {
-    if (parser.GetNextToken() != TOKEN_SYMBOL) {
-      throw InvalidFileException(parser.CreateLineMsg("Expecting file type"));
+    if (p_parser.GetNextToken() != TOKEN_SYMBOL) {
+      throw InvalidFileException(p_parser.CreateLineMsg("Expecting file type"));
     }
 
-    if (parser.GetLastText() == "NFG") {
+    if (p_parser.GetLastText() == "NFG") {
       TableFileGame data;
-      ParseNfgHeader(parser, data);
-      return BuildNfg(parser, data);
+      ParseNfgHeader(p_parser, data);
+      return BuildNfg(p_parser, data);
     }
-    else if (parser.GetLastText() == "EFG") {
+    else if (p_parser.GetLastText() == "EFG") {
       TreeData treeData;
       Game game = NewTree();
-      ParseEfg(parser, game, treeData);
+      ParseEfg(p_parser, game, treeData);
       return game;
     }
-    else if (parser.GetLastText() == "#AGG") {
+    else if (p_parser.GetLastText() == "#AGG") {
+      std::istringstream buffer(p_parser.GetRemainder());
       return GameAggRep::ReadAggFile(buffer);
     }
-    else if (parser.GetLastText() == "#BAGG") {
+    else if (p_parser.GetLastText() == "#BAGG") {
+      std::istringstream buffer(p_parser.GetRemainder());
       return GameBagentRep::ReadBaggFile(buffer);
     }
     else {
@@ -1092,4 +1221,91 @@ Game ReadGame(std::istream &p_file) throw (InvalidFileException)
   }
 }
 
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+//
+// A read-only mapping of the contents of a regular file into memory.
+// If the file cannot be mapped (for instance, if it is a pipe or a
+// device), IsMapped() returns false.  The pages of the file are shared
+// by all processes which map it.
+//
+class MappedFile : public GameTableStorage {
+private:
+  void *m_data;
+  size_t m_length;
+
+  MappedFile(void) : m_data(0), m_length(0) { }
+
+public:
+  MappedFile(const std::string &p_filename);
+  virtual ~MappedFile()  { if (m_data) munmap(m_data, m_length); }
+
+  bool IsMapped(void) const { return (m_data != 0); }
+  virtual const char *Begin(void) const 
+  { return static_cast<const char *>(m_data); }
+  virtual const char *End(void) const { return Begin() + m_length; }
+
+  /// Returns a new object which takes over the mapping from this one
+  MappedFile *Detach(void)
+  {
+    MappedFile *file = new MappedFile;
+    std::swap(m_data, file->m_data);
+    std::swap(m_length, file->m_length);
+    return file;
+  }
+};
+
+MappedFile::MappedFile(const std::string &p_filename)
+  : m_data(0), m_length(0)
+{
+  int fd = open(p_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+    void *data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      m_data = data;
+      m_length = info.st_size;
+#ifdef MADV_SEQUENTIAL
+      if (!GameTableRep::IsBinaryFile(Begin(), End())) {
+	// The payoffs of binary savefiles are accessed in any order
+	madvise(m_data, m_length, MADV_SEQUENTIAL);
+      }
+#endif  // MADV_SEQUENTIAL
+    }
+  }
+  close(fd);
+}
+#endif  // HAVE_SYS_MMAN_H && HAVE_MMAP
+
+}  // end anonymous namespace
+
+Game ReadGame(std::istream &p_file) throw (InvalidFileException)
+{
+  GameParserState parser(p_file);
+  return ParseGame(parser);
+}
+
+Game ReadGame(const std::string &p_filename) throw (InvalidFileException)
+{
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+  MappedFile mapping(p_filename);
+  if (mapping.IsMapped()) {
+    if (GameTableRep::IsBinaryFile(mapping.Begin(), mapping.End())) {
+      // The game refers directly to the mapped payoffs
+      return GameTableRep::ReadBinaryFile(mapping.Detach());
+    }
+    GameParserState parser(mapping.Begin(), mapping.End());
+    return ParseGame(parser);
+  }
+#endif  // HAVE_SYS_MMAN_H && HAVE_MMAP
+
+  std::ifstream file(p_filename.c_str());
+  if (!file.is_open()) {
+    throw InvalidFileException("Unable to open file '" + p_filename + "'");
+  }
+  return ReadGame(file);
+}
+
 } // end namespace Gambit
@@ -21,14 +21,72 @@
 //
 
 #include <iostream>
+#include <iomanip>
 #include <sstream>
 
 #include "libgambit.h"
 #include "gametree.h"
 #include "gametable.h"
+#include "tasks.h"
 
 namespace Gambit {
 
+//========================================================================
+//                            class Number
+//========================================================================
+
+#ifdef HAVE_PTHREAD_H
+namespace {
+
+pthread_mutex_t s_numberCreationLock = PTHREAD_MUTEX_INITIALIZER;
+
+//
+// Makes the writes to a newly created form visible to other threads
+// before the pointer to it, which readers load without the lock.
+// Readers only reach the form through the pointer, which orders their
+// loads on the platforms supported.
+//
+inline void PublishBarrier(void)
+{
+#ifdef __GNUC__
+  __sync_synchronize();
+#endif  // __GNUC__
+}
+
+}  // end anonymous namespace
+#endif  // HAVE_PTHREAD_H
+
+void Number::CreateRational(void) const
+{
+#ifdef HAVE_PTHREAD_H
+  MutexLock lock(s_numberCreationLock);
+#endif  // HAVE_PTHREAD_H
+  if (!m_rational) {
+    Rational *value = new Rational(m_double);
+#ifdef HAVE_PTHREAD_H
+    PublishBarrier();
+#endif  // HAVE_PTHREAD_H
+    m_rational = value;
+  }
+}
+
+void Number::CreateText(void) const
+{
+#ifdef HAVE_PTHREAD_H
+  MutexLock lock(s_numberCreationLock);
+#endif  // HAVE_PTHREAD_H
+  if (!m_text) {
+    std::ostringstream s;
+    s.setf(std::ios::fixed);
+    s << std::setprecision(0) << m_double;
+    std::string *value = new std::string(s.str());
+#ifdef HAVE_PTHREAD_H
+    PublishBarrier();
+#endif  // HAVE_PTHREAD_H
+    m_text = value;
+  }
+}
+
 //========================================================================
 //                       class GameOutcomeRep
 //========================================================================
@@ -53,6 +111,7 @@ void GameStrategyRep::DeleteStrategy(void)
     m_player->m_strategies[st]->m_number = st;
   }
   //m_player->m_game->RebuildTable();
+  m_player->m_game->ClearComputedValues();
   this->Invalidate();
 }
 
@@ -536,6 +595,9 @@ void GameExplicitRep::Write(std::ostream &p_stream,
 	   (p_format == "native" && !IsTree())) {
     WriteNfgFile(p_stream);
   }
+  else if (p_format == "binary") {
+    WriteBinaryFile(p_stream);
+  }
   else {
     throw UndefinedException();
   }
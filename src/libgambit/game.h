@@ -236,11 +236,7 @@ public:
   template <class T> const T &GetPayoff(int pl) const 
     { return (const T &) m_payoffs[pl]; }
   /// Sets the payoff to player 'pl'
-  void SetPayoff(int pl, const std::string &p_value)
-  {
-    m_payoffs[pl] = p_value;
-    //m_game->ClearComputedValues();
-  }
+  void SetPayoff(int pl, const std::string &p_value);
 
   /// Map the outcome to the corresponding outcome in the unrestricted game
   GameOutcome Unrestrict(void) const 
@@ -399,6 +395,7 @@ class GamePlayerRep : public GameObject {
   friend class GameTreeInfosetRep;
   friend class GameStrategyRep;
   friend class GameTreeNodeRep;
+  friend class GameTreeEvaluationView;
   friend class StrategySupportProfile;
   template <class T> friend class MixedBehaviorProfile;
   template <class T> friend class MixedStrategyProfile;
@@ -562,13 +559,13 @@ public:
   virtual Rational GetStrategyValue(const GameStrategy &) const = 0;
 
   /// Is the profile a pure strategy Nash equilibrium?
-  bool IsNash(void) const;
+  virtual bool IsNash(void) const;
 
   /// Is the profile a strict pure stategy Nash equilibrium?
   bool IsStrictNash(void) const;
 
   /// Is the specificed player playing a best response?
-  bool IsBestResponse(const GamePlayer &p_player) const;
+  virtual bool IsBestResponse(const GamePlayer &p_player) const;
 
   /// Get the list of best response strategies for a player
   List<GameStrategy> GetBestResponse(const GamePlayer &p_player) const;
@@ -648,6 +645,8 @@ public:
 
 /// This is the class for representing an arbitrary finite game.
 class GameRep : public GameObject {
+  friend class GameOutcomeRep;
+  friend class GameStrategyRep;
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
@@ -672,6 +671,8 @@ protected:
   virtual void BuildComputedValues(void) { }
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return false; }
+  /// Clear out any computed values which depend on outcome payoffs
+  virtual void ClearPayoffValues(void) const { }
   //@}
 
 
@@ -722,6 +723,20 @@ public:
   { GameInfoset s, t; return IsPerfectRecall(s, t); }
   //@}
 
+  /// @name Compiled payoff representation
+  //@{
+  /// \brief Sets whether payoffs are evaluated from a compiled table
+  ///
+  /// Representations which support it build a dense array of payoffs
+  /// (for each player, in contingency order) the first time a mixed
+  /// profile is evaluated, and use it for all subsequent evaluations
+  /// until the game is modified.  This trades memory for speed, and
+  /// is off by default.
+  virtual void SetCompiledPayoffs(bool) { }
+  /// Returns true if payoffs are evaluated from a compiled table
+  virtual bool UsesCompiledPayoffs(void) const { return false; }
+  //@}
+
   /// @name Writing data files
   //@{
   /// Write the game to a savefile in the specified format.
@@ -814,6 +829,11 @@ Game NewTable(const Array<int> &p_dim, bool p_sparseOutcomes = false);
 // all classes to be defined.
 
 inline Game GameOutcomeRep::GetGame(void) const { return m_game; }
+inline void GameOutcomeRep::SetPayoff(int pl, const std::string &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearPayoffValues();
+}
 
 inline GamePlayer GameStrategyRep::GetPlayer(void) const { return m_player; }
 
@@ -839,6 +859,11 @@ template<> inline std::string PureBehaviorProfile::GetPayoff(int pl) const
 
 /// Reads a game in .efg or .nfg format from the input stream
 Game ReadGame(std::istream &) throw (InvalidFileException);
+/// Reads a game in .efg or .nfg format from the named file.  Where
+/// possible, the file is mapped into memory and parsed in place; the
+/// payoffs of a table game in binary format are used where they lie,
+/// without being parsed at all.
+Game ReadGame(const std::string &p_filename) throw (InvalidFileException);
 
 } // end namespace gambit
 
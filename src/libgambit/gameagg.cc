@@ -97,6 +97,18 @@ GameAggRep::GameAggRep(agg* p_aggPtr)
     for (int st = 1; st <= m_players[pl]->m_strategies.Length();
 	 m_players[pl]->m_strategies[st++]->m_id = id++);
   }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init(&m_workspaceLock, 0);
+#endif  // HAVE_PTHREAD_H
+}
+
+GameAggRep::~GameAggRep()
+{
+  for (size_t i = 0; i < m_workspaces.size(); delete m_workspaces[i++]);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_destroy(&m_workspaceLock);
+#endif  // HAVE_PTHREAD_H
+  delete aggPtr;
 }
 
 Game GameAggRep::Copy(void) const
@@ -107,6 +119,37 @@ Game GameAggRep::Copy(void) const
   return ReadAggFile(is);
 }
 
+//------------------------------------------------------------------------
+//               GameAggRep: Computing expected payoffs
+//------------------------------------------------------------------------
+
+agg::Workspace *GameAggRep::AcquireWorkspace(void) const
+{
+  agg::Workspace *work = 0;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&m_workspaceLock);
+#endif  // HAVE_PTHREAD_H
+  if (!m_workspaces.empty()) {
+    work = m_workspaces.back();
+    m_workspaces.pop_back();
+  }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&m_workspaceLock);
+#endif  // HAVE_PTHREAD_H
+  return (work) ? work : new agg::Workspace(*aggPtr);
+}
+
+void GameAggRep::ReleaseWorkspace(agg::Workspace *p_work) const
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&m_workspaceLock);
+#endif  // HAVE_PTHREAD_H
+  m_workspaces.push_back(p_work);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&m_workspaceLock);
+#endif  // HAVE_PTHREAD_H
+}
+
 //------------------------------------------------------------------------
 //                  GameAggRep: Dimensions of the game
 //------------------------------------------------------------------------
@@ -25,6 +25,10 @@
 
 #include "libagg/agg.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
+
 class aggame;
 
 namespace Gambit {
@@ -38,17 +42,31 @@ class GameAggRep : public GameRep {
 private:
   agg *aggPtr;
   Array<GamePlayerRep *> m_players;
+  /// Workspaces for computing expected payoffs which are not in use
+  mutable std::vector<agg::Workspace *> m_workspaces;
+#ifdef HAVE_PTHREAD_H
+  mutable pthread_mutex_t m_workspaceLock;
+#endif  // HAVE_PTHREAD_H
 
   /// Constructor; takes ownership of the passed pointer
   GameAggRep(agg *);
 
+  /// @name Computing expected payoffs
+  //@{
+  /// Takes a workspace from the pool, creating one if none is free.
+  /// Computations through different workspaces may run concurrently.
+  agg::Workspace *AcquireWorkspace(void) const;
+  /// Returns a workspace taken by AcquireWorkspace() to the pool
+  void ReleaseWorkspace(agg::Workspace *) const;
+  //@}
+
 public:
   /// @name Lifecycle
   //@{
   /// Create a game from a serialized file in AGG format
   static Game ReadAggFile(std::istream &);
   /// Destructor
-  virtual ~GameAggRep() { delete aggPtr; }
+  virtual ~GameAggRep();
   /// Create a copy of the game, as a new game
   virtual Game Copy(void) const;
   //@}
@@ -22,9 +22,15 @@
 
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <stdint.h>
 
 #include "libgambit.h"
 #include "gametable.h"
+#include "tasks.h"
 
 namespace Gambit {
 
@@ -46,6 +52,8 @@ public:
   virtual void SetOutcome(GameOutcome p_outcome);
   virtual Rational GetPayoff(int pl) const;
   virtual Rational GetStrategyValue(const GameStrategy &) const;
+  virtual bool IsNash(void) const;
+  virtual bool IsBestResponse(const GamePlayer &p_player) const;
 };
 
 //------------------------------------------------------------------------
@@ -82,17 +90,18 @@ void TablePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
 
 GameOutcome TablePureStrategyProfileRep::GetOutcome(void) const
 { 
-  return dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index]; 
+  return dynamic_cast<GameTableRep &>(*m_nfg).GetContingencyOutcome(m_index - 1); 
 }
 
 void TablePureStrategyProfileRep::SetOutcome(GameOutcome p_outcome)
 {
   dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index] = p_outcome; 
+  m_nfg->ClearPayoffValues();
 }
 
 Rational TablePureStrategyProfileRep::GetPayoff(int pl) const
 {
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index];
+  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).GetContingencyOutcome(m_index - 1);
   if (outcome) {
     return outcome->GetPayoff<Rational>(pl);
   }
@@ -105,7 +114,7 @@ Rational
 TablePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
 {
   int player = p_strategy->GetPlayer()->GetNumber();
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index - m_profile[player]->m_offset + p_strategy->m_offset];
+  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).GetContingencyOutcome(m_index - 1 - m_profile[player]->m_offset + p_strategy->m_offset);
   if (outcome) {
     return outcome->GetPayoff<Rational>(player);
   }
@@ -114,6 +123,35 @@ TablePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) co
   }
 }
 
+//
+// When the game has compiled payoffs, these compare the payoff of the
+// contingency against the tabulated best payoff for each player, rather
+// than evaluating each possible deviation.
+//
+bool TablePureStrategyProfileRep::IsNash(void) const
+{
+  const GameTableRep &nfg = dynamic_cast<const GameTableRep &>(*m_nfg);
+  if (!nfg.UsesCompiledPayoffs()) {
+    return PureStrategyProfileRep::IsNash();
+  }
+  for (int pl = 1; pl <= nfg.NumPlayers(); pl++) {
+    if (!nfg.IsBestPayoff(pl, m_index - 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool 
+TablePureStrategyProfileRep::IsBestResponse(const GamePlayer &p_player) const
+{
+  const GameTableRep &nfg = dynamic_cast<const GameTableRep &>(*m_nfg);
+  if (!nfg.UsesCompiledPayoffs()) {
+    return PureStrategyProfileRep::IsBestResponse(p_player);
+  }
+  return nfg.IsBestPayoff(p_player->GetNumber(), m_index - 1);
+}
+
 PureStrategyProfile GameTableRep::NewPureStrategyProfile(void) const
 {
   return PureStrategyProfile(new TablePureStrategyProfileRep(const_cast<GameTableRep *>(this)));
@@ -140,7 +178,14 @@ int Product(const Array<int> &dim)
   
 GameTableRep::GameTableRep(const Array<int> &dim, 
 			   bool p_sparseOutcomes /* = false */)
+  : m_compiledPayoffs(false), 
+    m_doubleTableValid(false), m_rationalTableValid(false),
+    m_bestPayoffsValid(false),
+    m_storage(0), m_storedPayoffs(0)
 {
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init(&m_tableLock, 0);
+#endif  // HAVE_PTHREAD_H
   m_results = Array<GameOutcomeRep *>(Product(dim));
   for (int pl = 1; pl <= dim.Length(); pl++)  {
     m_players.Append(new GamePlayerRep(this, pl, dim[pl]));
@@ -164,6 +209,14 @@ GameTableRep::GameTableRep(const Array<int> &dim,
   }
 }
 
+GameTableRep::~GameTableRep()
+{
+  delete m_storage;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_destroy(&m_tableLock);
+#endif  // HAVE_PTHREAD_H
+}
+
 Game GameTableRep::Copy(void) const
 {
   std::ostringstream os;
@@ -200,6 +253,184 @@ bool GameTableRep::IsConstSum(void) const
   return true;
 }
 
+//------------------------------------------------------------------------
+//             GameTableRep: Compiled payoff representation
+//------------------------------------------------------------------------
+
+namespace {
+
+/// Fills p_table with the payoffs of each contingency in p_results,
+/// one array per player, indexed from zero in contingency order.
+template <class T>
+void CompilePayoffTable(const Array<GameOutcomeRep *> &p_results,
+			int p_numPlayers,
+			std::vector<std::vector<T> > &p_table)
+{
+  p_table.resize(p_numPlayers);
+  for (int pl = 1; pl <= p_numPlayers; pl++) {
+    std::vector<T> &payoffs = p_table[pl-1];
+    payoffs.resize(p_results.Length());
+    for (int cont = 1; cont <= p_results.Length(); cont++) {
+      GameOutcomeRep *outcome = p_results[cont];
+      payoffs[cont-1] = (outcome) ? outcome->GetPayoff<T>(pl) : T(0);
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+void GameTableRep::SetCompiledPayoffs(bool p_compiled)
+{
+  m_compiledPayoffs = p_compiled;
+  if (!m_compiledPayoffs) {
+    ClearPayoffValues();
+  }
+}
+
+const double *GameTableRep::BuildDoubleTable(int pl) const
+{
+  if (m_storage) {
+    return m_storedPayoffs + (long) (pl-1) * m_results.Length();
+  }
+  if (!m_doubleTableValid) {
+    CompilePayoffTable(m_results, m_players.Length(), m_doubleTable);
+    m_doubleTableValid = true;
+  }
+  return &m_doubleTable[pl-1][0];
+}
+
+const double *GameTableRep::GetPayoffTable(int pl, double) const
+{
+#ifdef HAVE_PTHREAD_H
+  MutexLock lock(m_tableLock);
+#endif  // HAVE_PTHREAD_H
+  return BuildDoubleTable(pl);
+}
+
+void GameTableRep::BuildRationalTable(void) const
+{
+  if (!m_rationalTableValid) {
+    CompilePayoffTable(m_results, m_players.Length(), m_rationalTable);
+    m_rationalTableValid = true;
+  }
+}
+
+const Rational *
+GameTableRep::GetPayoffTable(int pl, const Rational &) const
+{
+#ifdef HAVE_PTHREAD_H
+  MutexLock lock(m_tableLock);
+#endif  // HAVE_PTHREAD_H
+  BuildRationalTable();
+  return &m_rationalTable[pl-1][0];
+}
+
+const double *GameTableRep::GetBestPayoffTable(int pl) const
+{
+#ifdef HAVE_PTHREAD_H
+  MutexLock lock(m_tableLock);
+#endif  // HAVE_PTHREAD_H
+  if (!m_bestPayoffsValid) {
+    m_bestPayoffs.resize(m_players.Length());
+    long stride = 1L;
+    for (int i = 1; i <= m_players.Length(); i++) {
+      const double *payoffs = BuildDoubleTable(i);
+      int numStrategies = m_players[i]->m_strategies.size();
+      std::vector<double> &best = m_bestPayoffs[i-1];
+      best.resize(m_results.Length() / numStrategies);
+      for (long opp = 0; opp < (long) best.size(); opp++) {
+	// The contingency in which the player plays the first strategy
+	long index = (opp % stride) + (opp / stride) * stride * numStrategies;
+	double value = payoffs[index];
+	for (int st = 1; st < numStrategies; st++) {
+	  if (payoffs[index + st * stride] > value) {
+	    value = payoffs[index + st * stride];
+	  }
+	}
+	best[opp] = value;
+      }
+      stride *= numStrategies;
+    }
+    m_bestPayoffsValid = true;
+  }
+  return &m_bestPayoffs[pl-1][0];
+}
+
+namespace {
+
+/// The payoff of contingencies without an outcome
+const Number s_zeroPayoff;
+
+/// Payoffs as doubles closer than this, relative to their size, may be
+/// in either order exactly; this allows for the error in converting
+/// exact payoffs to doubles, which need not be correctly rounded
+const double c_roundingTolerance = 1.0e-12;
+
+}  // end anonymous namespace
+
+bool GameTableRep::IsHigherPayoff(int pl, long p_index1, long p_index2) const
+{
+  const GameOutcomeRep *outcome1 = m_results[p_index1 + 1];
+  const GameOutcomeRep *outcome2 = m_results[p_index2 + 1];
+  const Number &payoff1 = (outcome1) ? outcome1->m_payoffs[pl] : s_zeroPayoff;
+  const Number &payoff2 = (outcome2) ? outcome2->m_payoffs[pl] : s_zeroPayoff;
+  if (payoff1.IsSmallInteger() && payoff2.IsSmallInteger()) {
+    // These are exact as doubles, so no exact values need be created
+    return ((const double &) payoff1 > (const double &) payoff2);
+  }
+  return ((const Rational &) payoff1 > (const Rational &) payoff2);
+}
+
+bool GameTableRep::IsBestPayoff(int pl, long p_index, 
+				const double *p_payoffs,
+				const double *p_bestPayoffs) const
+{
+  long stride = 1L;
+  for (int i = 1; i < pl; i++) {
+    stride *= m_players[i]->m_strategies.size();
+  }
+  int numStrategies = m_players[pl]->m_strategies.size();
+  long size = stride * numStrategies;
+  double payoff = p_payoffs[p_index];
+  double best = p_bestPayoffs[(p_index % stride) + (p_index / size) * stride];
+  double tolerance = c_roundingTolerance * (std::fabs(payoff) + std::fabs(best));
+  if (best - payoff > tolerance) {
+    return false;
+  }
+
+  // Only strategies paying about as much or more may pay more exactly
+  long first = p_index - ((p_index / stride) % numStrategies) * stride;
+  for (int st = 0; st < numStrategies; st++) {
+    long index = first + st * stride;
+    if (index != p_index && p_payoffs[index] >= payoff - tolerance &&
+	IsHigherPayoff(pl, index, p_index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GameTableRep::ClearComputedValues(void) const
+{
+  ClearPayoffValues();
+}
+
+void GameTableRep::ClearPayoffValues(void) const
+{
+#ifdef HAVE_PTHREAD_H
+  MutexLock lock(m_tableLock);
+#endif  // HAVE_PTHREAD_H
+  m_doubleTableValid = m_rationalTableValid = false;
+  m_doubleTable.clear();
+  m_rationalTable.clear();
+  m_bestPayoffsValid = false;
+  m_bestPayoffs.clear();
+  // The payoffs in a binary savefile are out of date once the game changes
+  delete m_storage;
+  m_storage = 0;
+  m_storedPayoffs = 0;
+}
+
 //------------------------------------------------------------------------
 //                   GameTableRep: Writing data files
 //------------------------------------------------------------------------
@@ -275,6 +506,261 @@ void GameTableRep::WriteNfgFile(std::ostream &p_file) const
   p_file << '\n';
 }
 
+//------------------------------------------------------------------------
+//                   GameTableRep: Binary savefiles
+//------------------------------------------------------------------------
+
+namespace {
+
+/// The tag at the start of a binary savefile.  As in the PNG format,
+/// it includes characters which are altered by text-mode transfers.
+const char c_binaryTag[8] = { '\211', 'G', 'B', 'T', '\r', '\n', '\032', '\n' };
+const uint32_t c_binaryVersion = 1;
+/// Written as an integer, to detect a file from a machine of different
+/// byte order
+const uint32_t c_byteOrderMark = 0x01020304;
+
+template <class T> void WriteBinary(std::ostream &p_file, const T &p_value)
+{
+  p_file.write(reinterpret_cast<const char *>(&p_value), sizeof(T));
+}
+
+void WriteBinary(std::ostream &p_file, const std::string &p_text)
+{
+  WriteBinary(p_file, (uint32_t) p_text.length());
+  p_file.write(p_text.data(), p_text.length());
+}
+
+//
+// Reads the fields of a binary savefile in sequence, checking that
+// each lies within the file.
+//
+class BinaryFileReader {
+private:
+  const char *m_begin, *m_current, *m_end;
+
+public:
+  BinaryFileReader(const char *p_begin, const char *p_end)
+    : m_begin(p_begin), m_current(p_begin), m_end(p_end) { }
+
+  /// Returns the next p_length bytes, and moves past them
+  const char *Skip(size_t p_length)
+  {
+    if ((size_t) (m_end - m_current) < p_length) {
+      throw InvalidFileException("Binary savefile is truncated");
+    }
+    const char *data = m_current;
+    m_current += p_length;
+    return data;
+  }
+  /// Moves to the next multiple of p_size bytes from the start
+  void Align(size_t p_size)
+  { Skip((p_size - (m_current - m_begin) % p_size) % p_size); }
+
+  template <class T> T Read(void)
+  {
+    T value;
+    memcpy(&value, Skip(sizeof(T)), sizeof(T));
+    return value;
+  }
+  std::string ReadString(void)
+  {
+    uint32_t length = Read<uint32_t>();
+    return std::string(Skip(length), length);
+  }
+
+  const char *Current(void) const { return m_current; }
+  const char *End(void) const { return m_end; }
+};
+
+}  // end anonymous namespace
+
+void GameTableRep::WriteBinaryFile(std::ostream &p_file) const
+{
+  long size = m_results.Length();
+
+  // Payoffs other than integers are written out exactly, as text,
+  // indexed by their position in the array of payoffs
+  uint64_t numExact = 0;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    for (long cont = 1; cont <= size; cont++) {
+      if (m_results[cont] && !m_results[cont]->m_payoffs[pl].IsSmallInteger()) {
+	numExact++;
+      }
+    }
+  }
+
+  std::ostringstream header;
+  header.write(c_binaryTag, sizeof(c_binaryTag));
+  WriteBinary(header, c_binaryVersion);
+  WriteBinary(header, c_byteOrderMark);
+  WriteBinary(header, (uint32_t) m_players.Length());
+  WriteBinary(header, (uint32_t) 0);
+  WriteBinary(header, numExact);
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    WriteBinary(header, (uint32_t) m_players[pl]->m_strategies.Length());
+  }
+  WriteBinary(header, GetTitle());
+  WriteBinary(header, GetComment());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    WriteBinary(header, m_players[pl]->GetLabel());
+    for (int st = 1; st <= m_players[pl]->m_strategies.Length(); st++) {
+      WriteBinary(header, m_players[pl]->m_strategies[st]->GetLabel());
+    }
+  }
+  while (header.tellp() % sizeof(double) != 0) {
+    header.put('\0');
+  }
+  p_file << header.str();
+
+  std::vector<double> payoffs(size);
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    for (long cont = 1; cont <= size; cont++) {
+      GameOutcomeRep *outcome = m_results[cont];
+      payoffs[cont-1] = (outcome) ? outcome->GetPayoff<double>(pl) : 0.0;
+    }
+    p_file.write(reinterpret_cast<const char *>(&payoffs[0]),
+		 size * sizeof(double));
+  }
+
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    for (long cont = 1; cont <= size; cont++) {
+      GameOutcomeRep *outcome = m_results[cont];
+      if (outcome && !outcome->m_payoffs[pl].IsSmallInteger()) {
+	WriteBinary(p_file, (uint64_t) ((pl-1) * size + cont-1));
+	WriteBinary(p_file, outcome->GetPayoff<std::string>(pl));
+      }
+    }
+  }
+}
+
+bool GameTableRep::IsBinaryFile(const char *p_begin, const char *p_end)
+{
+  return ((size_t) (p_end - p_begin) >= sizeof(c_binaryTag) &&
+	  std::equal(c_binaryTag, c_binaryTag + sizeof(c_binaryTag), p_begin));
+}
+
+Game GameTableRep::ReadBinaryFile(GameTableStorage *p_storage)
+{
+  Array<int> dim;
+  Array<std::string> labels;
+  const double *payoffs;
+  const char *exact, *exactEnd;
+  uint64_t numPayoffs;
+  try {
+    if (!IsBinaryFile(p_storage->Begin(), p_storage->End())) {
+      throw InvalidFileException("Not a binary savefile");
+    }
+    BinaryFileReader reader(p_storage->Begin(), p_storage->End());
+    reader.Skip(sizeof(c_binaryTag));
+    if (reader.Read<uint32_t>() != c_binaryVersion) {
+      throw InvalidFileException("Unsupported version of binary savefile");
+    }
+    if (reader.Read<uint32_t>() != c_byteOrderMark) {
+      throw InvalidFileException("Binary savefile has a different byte order");
+    }
+    uint32_t numPlayers = reader.Read<uint32_t>();
+    reader.Read<uint32_t>();
+    uint64_t numExact = reader.Read<uint64_t>();
+    if (numPlayers == 0 || numPlayers > INT_MAX) {
+      throw InvalidFileException("Invalid number of players");
+    }
+    
+    long size = 1L;
+    for (uint32_t pl = 1; pl <= numPlayers; pl++) {
+      uint32_t numStrategies = reader.Read<uint32_t>();
+      if (numStrategies == 0 || numStrategies > (uint32_t) (INT_MAX / size)) {
+	throw InvalidFileException("Invalid number of strategies");
+      }
+      dim.Append(numStrategies);
+      size *= numStrategies;
+    }
+    numPayoffs = (uint64_t) numPlayers * (uint64_t) size;
+    // Title and comment, then each player followed by their strategies
+    labels.Append(reader.ReadString());
+    labels.Append(reader.ReadString());
+    for (uint32_t pl = 1; pl <= numPlayers; pl++) {
+      for (int st = 0; st <= dim[pl]; st++) {
+	labels.Append(reader.ReadString());
+      }
+    }
+
+    reader.Align(sizeof(double));
+    if ((uint64_t) (reader.End() - reader.Current()) / sizeof(double) / numPlayers
+	< (uint64_t) size) {
+      throw InvalidFileException("Binary savefile is truncated");
+    }
+    payoffs = reinterpret_cast<const double *>
+      (reader.Skip(numPayoffs * sizeof(double)));
+
+    // The exact payoffs must be in order of their positions
+    exact = reader.Current();
+    uint64_t last = 0;
+    for (uint64_t i = 0; i < numExact; i++) {
+      uint64_t position = reader.Read<uint64_t>();
+      if ((i > 0 && position <= last) || position >= numPayoffs) {
+	throw InvalidFileException("Invalid exact payoff in binary savefile");
+      }
+      last = position;
+      reader.ReadString();
+    }
+    exactEnd = reader.Current();
+  }
+  catch (...) {
+    delete p_storage;
+    throw;
+  }
+
+  GameTableRep *table = new GameTableRep(dim);
+  Game game = table;
+  table->m_storage = p_storage;
+  table->m_storedPayoffs = payoffs;
+  // The stored payoffs already serve as a compiled table
+  table->m_compiledPayoffs = true;
+
+  int i = 1;
+  table->SetTitle(labels[i++]);
+  table->SetComment(labels[i++]);
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    table->m_players[pl]->SetLabel(labels[i++]);
+    for (int st = 1; st <= dim[pl]; st++) {
+      table->m_players[pl]->m_strategies[st]->SetLabel(labels[i++]);
+    }
+  }
+
+  // Each contingency has its own outcome.  The positions of the exact
+  // payoffs were checked to be increasing above.
+  BinaryFileReader reader(exact, exactEnd);
+  bool haveExact = (reader.Current() < reader.End());
+  uint64_t nextExact = (haveExact) ? reader.Read<uint64_t>() : 0;
+  const double *payoff = payoffs;
+  long size = table->m_results.Length();
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    for (long cont = 1; cont <= size; cont++, payoff++) {
+      Number &number = table->m_outcomes[cont]->m_payoffs[pl];
+      if (haveExact && (uint64_t) (payoff - payoffs) == nextExact) {
+	try {
+	  number = reader.ReadString();
+	}
+	catch (ValueException &) {
+	  throw InvalidFileException("Invalid exact payoff in binary savefile");
+	}
+	haveExact = (reader.Current() < reader.End());
+	if (haveExact) {
+	  nextExact = reader.Read<uint64_t>();
+	}
+      }
+      else if (*payoff == floor(*payoff) && fabs(*payoff) < 1.0e15) {
+	number.SetSmallInteger(*payoff);
+      }
+      else {
+	number = lexical_cast<std::string>(Rational(*payoff));
+      }
+    }
+  }
+  return game;
+}
+
 //------------------------------------------------------------------------
 //                       GameTableRep: Players
 //------------------------------------------------------------------------
@@ -373,6 +859,7 @@ void GameTableRep::RebuildTable(void)
   m_results = newResults;
 
   IndexStrategies();
+  ClearComputedValues();
 }
 
 void GameTableRep::IndexStrategies(void)
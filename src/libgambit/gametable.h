@@ -23,10 +23,28 @@
 #ifndef GAMETABLE_H
 #define GAMETABLE_H
 
+#include <vector>
 #include "gameexpl.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
+
 namespace Gambit {
 
+/// \brief The contents of a binary savefile of a table game
+///
+/// A table game read from a binary savefile takes its payoffs directly
+/// from the contents of the file (usually mapped into memory), and
+/// keeps the contents until its payoffs change.
+class GameTableStorage {
+public:
+  virtual ~GameTableStorage() { }
+
+  virtual const char *Begin(void) const = 0;
+  virtual const char *End(void) const = 0;
+};
+
 class GameTableRep : public GameExplicitRep {
   friend class StrategySupportProfile;
   friend class GamePlayerRep;
@@ -38,18 +56,74 @@ private:
   Array<GameOutcomeRep *> m_results;
   Game m_unrestricted;
 
+  /// @name Compiled payoff tables
+  ///
+  /// Dense per-player payoff arrays, indexed by the sum of the
+  /// strategy offsets of a contingency (that is, one less than the
+  /// index into m_results).  These are built on demand when
+  /// m_compiledPayoffs is set, and discarded whenever the game changes.
+  //@{
+  bool m_compiledPayoffs;
+  mutable bool m_doubleTableValid, m_rationalTableValid;
+  mutable std::vector<std::vector<double> > m_doubleTable;
+  mutable std::vector<std::vector<Rational> > m_rationalTable;
+  //@}
+
+  /// @name Best-response payoff tables
+  ///
+  /// For each player, the best payoff as a double the player can
+  /// obtain against each profile of strategies of the other players.
+  /// Like the compiled payoff tables, these are built on demand when
+  /// m_compiledPayoffs is set, and discarded whenever the game changes.
+  //@{
+  mutable bool m_bestPayoffsValid;
+  mutable std::vector<std::vector<double> > m_bestPayoffs;
+  //@}
+
+  /// @name Payoffs in a binary savefile
+  ///
+  /// A game read from a binary savefile keeps the contents of the file,
+  /// and its payoffs there serve as the compiled table of payoffs as
+  /// doubles, until the payoffs of the game change.
+  //@{
+  mutable GameTableStorage *m_storage;
+  mutable const double *m_storedPayoffs;
+  //@}
+
+#ifdef HAVE_PTHREAD_H
+  /// Held while building or discarding the tables above, which may be
+  /// requested from several threads at once
+  mutable pthread_mutex_t m_tableLock;
+#endif  // HAVE_PTHREAD_H
+
+  /// Returns the compiled table of payoffs as doubles for player pl,
+  /// building it if needed, with m_tableLock held
+  const double *BuildDoubleTable(int pl) const;
+  /// Builds the compiled table of exact payoffs, with m_tableLock held
+  void BuildRationalTable(void) const;
+  /// Returns true if the exact payoff to player pl in the contingency
+  /// with (zero-based) index p_index1 exceeds that in p_index2
+  bool IsHigherPayoff(int pl, long p_index1, long p_index2) const;
+
   /// @name Private auxiliary functions
   //@{
   void IndexStrategies(void);
   void RebuildTable(void);
   //@}
 
+  /// @name Managing the representation
+  //@{
+  virtual void ClearComputedValues(void) const;
+  virtual void ClearPayoffValues(void) const;
+  //@}
+
 public:
   /// @name Lifecycle
   //@{
   /// Construct a new table game with the given dimension
   /// If p_sparseOutcomes = true, outcomes for all contingencies are left null
   GameTableRep(const Array<int> &p_dim, bool p_sparseOutcomes = false);
+  virtual ~GameTableRep();
   virtual Game Copy(void) const;
   //@}
 
@@ -116,9 +190,80 @@ public:
   virtual void DeleteOutcome(const GameOutcome &);
   //@}
 
-  /// @name Writing data files
+  /// @name Contingencies
+  //@{
+  /// Returns the number of contingencies (pure strategy profiles)
+  long NumContingencies(void) const { return m_results.Length(); }
+  /// \brief Returns the outcome of the contingency with the given index
+  ///
+  /// Contingencies are indexed from zero, with the first player's
+  /// strategy varying fastest: strategy j of player i contributes
+  /// (j-1) times the product of the numbers of strategies of players
+  /// 1 through i-1 to the index.  Returns null if no outcome is assigned.
+  GameOutcomeRep *GetContingencyOutcome(long p_index) const
+  { return m_results[p_index + 1]; }
+  //@}
+
+  /// @name Reading and writing data files
   //@{
   virtual void WriteNfgFile(std::ostream &) const;
+  /// \brief Writes the game in the binary savefile format
+  ///
+  /// The file consists of a header with the dimensions and labels of
+  /// the game, followed by the payoffs as doubles for each player in
+  /// turn, in contingency order, and finally the exact text of each
+  /// payoff which is not an integer.  Integers are native-endian, and
+  /// the payoffs are aligned to eight bytes from the start of the file.
+  /// Outcome labels are not saved, and each contingency has its own
+  /// outcome when the game is read back.
+  virtual void WriteBinaryFile(std::ostream &) const;
+  /// Returns true if the range starts with the tag of a binary savefile
+  static bool IsBinaryFile(const char *p_begin, const char *p_end);
+  /// \brief Reads a game from the contents of a binary savefile
+  ///
+  /// The game takes ownership of the storage, which is deleted, even if
+  /// reading fails, when it is no longer needed.
+  static Game ReadBinaryFile(GameTableStorage *p_storage);
+  //@}
+
+  /// @name Compiled payoff representation
+  //@{
+  virtual void SetCompiledPayoffs(bool p_compiled);
+  virtual bool UsesCompiledPayoffs(void) const { return m_compiledPayoffs; }
+  /// \brief Returns the compiled payoff table for player pl
+  ///
+  /// The table is built if needed.  It may be requested from several
+  /// threads at once, and stays valid until the payoffs of the game
+  /// change.
+  const double *GetPayoffTable(int pl, double) const;
+  /// Returns the compiled payoff table for player pl, building it if needed
+  const Rational *GetPayoffTable(int pl, const Rational &) const;
+  /// \brief Returns the table of best payoffs to player pl, as doubles
+  ///
+  /// The table has an entry for each profile of strategies of the
+  /// other players, indexed by the index of the contingency in which
+  /// player pl plays the first strategy, with player pl left out of
+  /// the indexing.  The tables are built for all players in one pass
+  /// the first time one is needed.  Like the compiled payoff tables,
+  /// they may be requested from several threads at once, and stay
+  /// valid until the payoffs of the game change.
+  const double *GetBestPayoffTable(int pl) const;
+  /// \brief Returns true if player pl cannot gain by deviating
+  ///
+  /// Returns true if no strategy of player pl pays more than the one
+  /// played in the contingency with the given (zero-based) index,
+  /// holding fixed the strategies of the others.  This is decided from
+  /// the player's tables of payoffs and best payoffs as doubles, as
+  /// returned by GetPayoffTable() and GetBestPayoffTable(); exact
+  /// payoffs are compared only where rounding leaves the order in
+  /// doubt.  Passing the tables lets callers on several threads check
+  /// contingencies without locking.
+  bool IsBestPayoff(int pl, long p_index, const double *p_payoffs,
+		    const double *p_bestPayoffs) const;
+  /// As above, using the game's tables
+  bool IsBestPayoff(int pl, long p_index) const
+  { return IsBestPayoff(pl, p_index, GetPayoffTable(pl, 0.0),
+			GetBestPayoffTable(pl)); }
   //@}
 
   virtual PureStrategyProfile NewPureStrategyProfile(void) const;
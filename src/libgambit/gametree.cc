@@ -25,6 +25,7 @@
 
 #include "libgambit.h"
 #include "gametree.h"
+#include "tasks.h"
 
 namespace Gambit {
 
@@ -539,6 +540,84 @@ GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 }
 
 
+//========================================================================
+//                     class GameTreeEvaluationView
+//========================================================================
+
+GameTreeEvaluationView::GameTreeEvaluationView(GameTreeRep *p_efg)
+  : m_parent(p_efg->NumNodes()), m_branch(m_parent.Length()),
+    m_lastDescendant(m_parent.Length()), m_infoset(m_parent.Length()),
+    m_firstChild(m_parent.Length()), m_numChildren(m_parent.Length()),
+    m_children(m_parent.Length() - 1), m_outcomes(m_parent.Length()),
+    m_playerOffset(0, p_efg->NumPlayers()), m_numActions(0)
+{
+  // Players are taken in order, with chance (player number zero) last
+  int numInfosets = 0, numMembers = 0;
+  for (int pl = 1; pl <= p_efg->NumPlayers() + 1; pl++) {
+    GamePlayerRep *player = ((pl <= p_efg->NumPlayers()) ? 
+			     p_efg->m_players[pl] : p_efg->m_chance);
+    m_playerOffset[player->GetNumber()] = numInfosets;
+    numInfosets += player->m_infosets.Length();
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      numMembers += player->m_infosets[iset]->m_members.Length();
+    }
+  }
+
+  m_infosets = Array<GameTreeInfosetRep *>(numInfosets);
+  m_firstAction = Array<int>(numInfosets);
+  m_firstMember = Array<int>(numInfosets + 1);
+  m_members = Array<int>(numMembers);
+  numMembers = 0;
+  for (int pl = 1; pl <= p_efg->NumPlayers() + 1; pl++) {
+    GamePlayerRep *player = ((pl <= p_efg->NumPlayers()) ? 
+			     p_efg->m_players[pl] : p_efg->m_chance);
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      int i = m_playerOffset[player->GetNumber()] + iset;
+      m_infosets[i] = infoset;
+      m_firstAction[i] = m_numActions;
+      m_numActions += infoset->m_actions.Length();
+      m_firstMember[i] = numMembers;
+      for (int j = 1; j <= infoset->m_members.Length(); j++) {
+	m_members[++numMembers] = infoset->m_members[j]->number;
+      }
+    }
+  }
+  m_firstMember[numInfosets + 1] = numMembers;
+
+  int offset = 0;
+  m_parent[p_efg->m_root->number] = 0;
+  m_branch[p_efg->m_root->number] = 0;
+  AddNode(p_efg->m_root, offset);
+}
+
+void GameTreeEvaluationView::AddNode(GameTreeNodeRep *p_node, int &p_offset)
+{
+  int n = p_node->number;
+  m_outcomes[n] = p_node->outcome;
+  m_numChildren[n] = p_node->children.Length();
+  m_firstChild[n] = p_offset;
+  p_offset += m_numChildren[n];
+
+  if (!p_node->infoset) {
+    m_infoset[n] = 0;
+    m_lastDescendant[n] = n;
+    return;
+  }
+
+  int i = GetInfosetIndex(p_node->infoset->m_player->GetNumber(),
+			  p_node->infoset->m_number);
+  m_infoset[n] = i;
+  for (int c = 1; c <= p_node->children.Length(); c++) {
+    GameTreeNodeRep *child = p_node->children[c];
+    m_children[m_firstChild[n] + c] = child->number;
+    m_parent[child->number] = n;
+    m_branch[child->number] = m_firstAction[i] + c;
+    AddNode(child, p_offset);
+  }
+  m_lastDescendant[n] = m_lastDescendant[GetChild(n, m_numChildren[n])];
+}
+
 //========================================================================
 //                           class GameTreeRep
 //========================================================================
@@ -548,7 +627,11 @@ GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 //------------------------------------------------------------------------
 
 GameTreeRep::GameTreeRep(void)
+  : m_view(0)
 {
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init(&m_viewLock, 0);
+#endif  // HAVE_PTHREAD_H
   m_computedValues = false;
   m_chance = new GamePlayerRep(this, 0);
   m_root = new GameTreeNodeRep(this, 0);
@@ -556,6 +639,10 @@ GameTreeRep::GameTreeRep(void)
 
 GameTreeRep::~GameTreeRep()
 {
+  delete m_view;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_destroy(&m_viewLock);
+#endif  // HAVE_PTHREAD_H
   m_root->Invalidate();
   m_chance->Invalidate();
 }
@@ -738,6 +825,8 @@ void GameTreeRep::ClearComputedValues(void) const
     }
   }
 
+  delete m_view;
+  m_view = 0;
   m_computedValues = false;
 }
 
@@ -756,9 +845,25 @@ void GameTreeRep::BuildComputedValues(void)
 	 m_players[pl]->m_strategies[st++]->m_id = id++);
   }
 
+  GetEvaluationView();
+
   m_computedValues = true;
 }
 
+const GameTreeEvaluationView &GameTreeRep::GetEvaluationView(void) const
+{
+  // The view does not require the reduced strategies, which can be
+  // expensive to build on large trees, so it is built on its own if
+  // the other computed values have not been.
+#ifdef HAVE_PTHREAD_H
+  MutexLock lock(m_viewLock);
+#endif  // HAVE_PTHREAD_H
+  if (!m_view) {
+    m_view = new GameTreeEvaluationView(const_cast<GameTreeRep *>(this));
+  }
+  return *m_view;
+}
+
 //------------------------------------------------------------------------
 //                  GameTreeRep: Writing data files
 //------------------------------------------------------------------------
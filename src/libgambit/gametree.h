@@ -25,6 +25,10 @@
 
 #include "gameexpl.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
+
 namespace Gambit {
 
 class GameTreeRep;
@@ -61,6 +65,7 @@ class GameTreeInfosetRep : public GameInfosetRep {
   friend class GameTreeActionRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
+  friend class GameTreeEvaluationView;
   template <class T> friend class MixedBehaviorProfile;
 
 protected:
@@ -132,6 +137,7 @@ class GameTreeNodeRep : public GameNodeRep {
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class PureBehaviorProfile;
+  friend class GameTreeEvaluationView;
   template <class T> friend class MixedBehaviorProfile;
   
 protected:
@@ -196,14 +202,97 @@ public:
 };
 
 
+///
+/// A compiled, read-only view of the structure of a game tree, used in
+/// evaluating behavior profiles.  Nodes are referred to by their numbers,
+/// which run in depth-first order, so that a node's parent always precedes
+/// it and the nodes in its subtree follow it contiguously.  Information
+/// sets are indexed consecutively, those of the personal players in order
+/// first, then those of chance.  The actions at each information set are
+/// numbered consecutively as well, so that the probabilities of all actions
+/// in the game can be held in a single array; "branch" of a node refers to
+/// the action leading to it.
+///
+/// The view refers to the outcomes at the nodes, not their payoffs, so it
+/// remains valid when payoffs change.  It is discarded with the other
+/// computed values whenever the tree is changed, and built again the next
+/// time it is requested; as the tree may not be changed while it is being
+/// read, the view may then be requested from several threads at once.
+///
+class GameTreeEvaluationView {
+  friend class GameTreeRep;
+
+private:
+  // Nodes
+  Array<int> m_parent, m_branch, m_lastDescendant, m_infoset;
+  Array<int> m_firstChild, m_numChildren, m_children;
+  Array<GameOutcomeRep *> m_outcomes;
+  // Information sets
+  Array<GameTreeInfosetRep *> m_infosets;
+  Array<int> m_firstAction, m_firstMember, m_members;
+  Array<int> m_playerOffset;
+  int m_numActions;
+
+  GameTreeEvaluationView(GameTreeRep *);
+
+  void AddNode(GameTreeNodeRep *, int &p_offset);
+
+public:
+  /// @name Nodes
+  //@{
+  /// Returns the number of nodes in the tree
+  int NumNodes(void) const { return m_parent.Length(); }
+  /// Returns the parent of the node, or zero for the root
+  int GetParent(int n) const { return m_parent[n]; }
+  /// Returns the index of the action leading to the node (zero for the root)
+  int GetBranch(int n) const { return m_branch[n]; }
+  /// Returns the highest-numbered node in the subtree rooted at the node
+  int GetLastDescendant(int n) const { return m_lastDescendant[n]; }
+  /// Returns the information set at the node, or zero if terminal
+  int GetInfoset(int n) const { return m_infoset[n]; }
+  /// Returns the number of children of the node
+  int NumChildren(int n) const { return m_numChildren[n]; }
+  /// Returns the i'th child of the node
+  int GetChild(int n, int i) const { return m_children[m_firstChild[n] + i]; }
+  /// Returns the outcome attached to the node, or null if none
+  GameOutcomeRep *GetOutcome(int n) const { return m_outcomes[n]; }
+  //@}
+
+  /// @name Information sets and actions
+  //@{
+  /// Returns the number of information sets, including chance's
+  int NumInfosets(void) const { return m_infosets.Length(); }
+  /// Returns the index of information set 'iset' of player 'pl'
+  int GetInfosetIndex(int pl, int iset) const 
+    { return m_playerOffset[pl] + iset; }
+  /// Returns the information set with the given index
+  GameTreeInfosetRep *GetInfosetRep(int i) const { return m_infosets[i]; }
+  /// Returns the number of actions in the game, including chance's
+  int NumActions(void) const { return m_numActions; }
+  /// Returns the index of the a'th action at the information set
+  int GetAction(int i, int a) const { return m_firstAction[i] + a; }
+  /// Returns the number of members of the information set
+  int NumMembers(int i) const 
+    { return m_firstMember[i+1] - m_firstMember[i]; }
+  /// Returns the j'th member of the information set
+  int GetMember(int i, int j) const { return m_members[m_firstMember[i] + j]; }
+  //@}
+};
+
 class GameTreeRep : public GameExplicitRep {
   friend class GameTreeNodeRep;
   friend class GameTreeInfosetRep;
   friend class GameTreeActionRep;
+  friend class GameTreeEvaluationView;
 protected:
   mutable bool m_computedValues;
   GameTreeNodeRep *m_root;
   GamePlayerRep *m_chance;
+  mutable GameTreeEvaluationView *m_view;
+#ifdef HAVE_PTHREAD_H
+  /// Held while building the evaluation view
+  mutable pthread_mutex_t m_viewLock;
+#endif  // HAVE_PTHREAD_H
 
   /// @name Private auxiliary functions
   //@{
@@ -249,6 +338,8 @@ public:
   virtual GameNode GetRoot(void) const { return m_root; } 
   /// Returns the number of nodes in the game
   int NumNodes(void) const;
+  /// Returns the compiled view of the tree for evaluating profiles
+  const GameTreeEvaluationView &GetEvaluationView(void) const;
   //@}
 
   virtual void DeleteOutcome(const GameOutcome &);
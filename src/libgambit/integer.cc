@@ -122,6 +122,49 @@ inline static unsigned long up(unsigned long x)
   return x << I_SHIFT;
 }
 
+// overflow-checked arithmetic on values of magnitude at most LONG_MAX,
+// as held inline by an Integer.  Each returns false, without touching r,
+// if the result would not be of magnitude at most LONG_MAX.
+
+#define I_HALFLONG      (1UL << (sizeof(long) * CHAR_BIT / 2 - 1))
+
+inline static bool Iadd_long(long x, long y, long& r)
+{
+  if ((y > 0) ? x > LONG_MAX - y : x < -LONG_MAX - y)
+    return false;
+  r = x + y;
+  return true;
+}
+
+inline static bool Isub_long(long x, long y, long& r)
+{
+  if ((y < 0) ? x > LONG_MAX + y : x < -LONG_MAX + y)
+    return false;
+  r = x - y;
+  return true;
+}
+
+inline static bool Imul_long(long x, long y, long& r)
+{
+  unsigned long ux = (x < 0) ? -(unsigned long) x : x;
+  unsigned long uy = (y < 0) ? -(unsigned long) y : y;
+  if ((ux | uy) >= I_HALFLONG && uy != 0 && 
+      ux > (unsigned long) LONG_MAX / uy)
+    return false;
+  r = x * y;
+  return true;
+}
+
+inline static int Icompare_long(long x, long y)
+{
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+inline static unsigned long Iabs_long(long x)
+{
+  return (x < 0) ? -(unsigned long) x : x;
+}
+
 // compare two equal-length reps
 
 static int docmp(const unsigned short* x, const unsigned short* y, int l)
@@ -309,7 +352,7 @@ IntegerRep* Icopy(IntegerRep* old, const IntegerRep* src)
 IntegerRep* Icopy_long(IntegerRep* old, long x)
 {
   int newsgn = (x >= 0);
-  IntegerRep* rep = Icopy_ulong(old, newsgn ? x : -x);
+  IntegerRep* rep = Icopy_ulong(old, newsgn ? x : -(unsigned long) x);
   rep->sgn = newsgn;
   return rep;
 }
@@ -322,7 +365,7 @@ IntegerRep* Icopy_ulong(IntegerRep* old, unsigned long x)
   while (x != 0)
   {
     src[srclen++] = extract(x);
-    x = down(x);
+    x >>= I_SHIFT;
   }
 
   IntegerRep* rep;
@@ -463,6 +506,27 @@ double Itodouble(const IntegerRep* rep)
     return d;
 }
 
+// approximate as a mantissa and binary exponent, using only the
+// leading digits, so the exponent may be outside the range of a double
+
+double Ifrexp(const IntegerRep* rep, long& e)
+{
+  int l = rep->len;
+  int n = (l < 4) ? l : 4;
+  double d = 0.0;
+  for (int i = l - 1; i >= l - n; --i)
+    d = d * I_RADIX + rep->s[i];
+  if (d == 0.0)
+  {
+    e = 0;
+    return 0.0;
+  }
+  int k;
+  d = std::frexp(d, &k);
+  e = k + (long) (l - n) * I_SHIFT;
+  return (rep->sgn == I_NEGATIVE) ? -d : d;
+}
+
 // see whether op double() will work-
 // have to actually try it in order to find out
 // since otherwise might trigger fp exception
@@ -502,7 +566,10 @@ double ratio(const Integer& num, const Integer& den)
     double  d2 = 0.0;
     double  d3 = 0.0; 
     int cont = 1;
-    for (int i = den.rep->len - 1; i >= 0 && cont; --i)
+    LongIntegerRep dbuf, rbuf;
+    const IntegerRep* dr = den.Rep(dbuf);
+    const IntegerRep* rr = r.Rep(rbuf);
+    for (int i = dr->len - 1; i >= 0 && cont; --i)
     {
 		unsigned short a = (unsigned short) (I_RADIX >> 1);
       while (a != 0)
@@ -514,13 +581,13 @@ double ratio(const Integer& num, const Integer& den)
         }
 
         d2 *= 2.0;
-        if (den.rep->s[i] & a)
+        if (dr->s[i] & a)
           d2 += 1.0;
 
-        if (i < r.rep->len)
+        if (i < rr->len)
         {
           d3 *= 2.0;
-          if (r.rep->s[i] & a)
+          if (rr->s[i] & a)
             d3 += 1.0;
         }
 
@@ -1349,7 +1416,16 @@ IntegerRep* div(const IntegerRep* x, long y, IntegerRep* q)
 
 void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
 {
-  const IntegerRep* x = Ix.rep;
+  if (Ix.rep == 0 && y != 0)
+  {
+    long x = Ix.val;
+    rem = x % y;
+    Iq = x / y;
+    return;
+  }
+
+  LongIntegerRep xbuf;
+  const IntegerRep* x = Ix.Rep(xbuf);
   nonnil(x);
   IntegerRep* q = Iq.rep;
   int xl = x->len;
@@ -1429,14 +1505,24 @@ void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
   q->sgn = samesign;
   Icheck(q);
   Iq.rep = q;
+  Iq.Shrink();
 }
 
 
 void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
 {
-  const IntegerRep* x = Ix.rep;
+  if (Ix.rep == 0 && Iy.rep == 0 && Iy.val != 0)
+  {
+    long x = Ix.val, y = Iy.val;
+    Iq = x / y;
+    Ir = x % y;
+    return;
+  }
+
+  LongIntegerRep xbuf, ybuf;
+  const IntegerRep* x = Ix.Rep(xbuf);
   nonnil(x);
-  const IntegerRep* y = Iy.rep;
+  const IntegerRep* y = Iy.Rep(ybuf);
   nonnil(y);
   IntegerRep* q = Iq.rep;
   IntegerRep* r = Ir.rep;
@@ -1497,12 +1583,15 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
       Icheck(r);
       unscale(r->s, r->len, prescale, r->s);
     }
+    r->sgn = xsgn;   // the remainder takes the sign of the dividend
   }
   q->sgn = samesign;
   Icheck(q);
   Iq.rep = q;
+  Iq.Shrink();
   Icheck(r);
   Ir.rep = r;
+  Ir.Shrink();
 }
 
 IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
@@ -1555,6 +1644,7 @@ IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
       Icheck(r);
       unscale(r->s, r->len, prescale, r->s);
     }
+    r->sgn = xsgn;   // the remainder takes the sign of the dividend
   }
   Icheck(r);
   return r;
@@ -1856,11 +1946,15 @@ void (setbit)(Integer& x, long b)
   {
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
-    int xl = x.rep ? x.rep->len : 0;
+    LongIntegerRep xbuf;
+    if (x.rep == 0)
+      x.rep = Icopy(0, x.Rep(xbuf));
+    int xl = x.rep->len;
     if (xl <= bw)
       x.rep = Iresize(x.rep, calc_len(xl, bw+1, 0));
     x.rep->s[bw] |= (1 << sw);
     Icheck(x.rep);
+    x.Shrink();
   }
 }
 
@@ -1868,26 +1962,27 @@ void clearbit(Integer& x, long b)
 {
   if (b >= 0)
     {
+      LongIntegerRep xbuf;
       if (x.rep == 0)
-	x.rep = &_ZeroRep;
-      else
-	{
-	  int bw = (int) ((unsigned long)b / I_SHIFT);
-	  int sw = (int) ((unsigned long)b % I_SHIFT);
-	  if (x.rep->len > bw)
-	    x.rep->s[bw] &= ~(1 << sw);
-	}
+	x.rep = Icopy(0, x.Rep(xbuf));
+      int bw = (int) ((unsigned long)b / I_SHIFT);
+      int sw = (int) ((unsigned long)b % I_SHIFT);
+      if (x.rep->len > bw)
+	x.rep->s[bw] &= ~(1 << sw);
     Icheck(x.rep);
+    x.Shrink();
   }
 }
 
 int testbit(const Integer& x, long b)
 {
-  if (x.rep != 0 && b >= 0)
+  if (b >= 0)
   {
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
-    return (bw < x.rep->len && (x.rep->s[bw] & (1 << sw)) != 0);
+    LongIntegerRep xbuf;
+    const IntegerRep* r = x.Rep(xbuf);
+    return (bw < r->len && (r->s[bw] & (1 << sw)) != 0);
   }
   else
     return 0;
@@ -2196,7 +2291,8 @@ std::string Itoa(const IntegerRep *x, int base, int width)
 
 std::ostream &operator<<(std::ostream &s, const Integer &y)
 {
-  return s << Itoa(y.rep);
+  LongIntegerRep ybuf;
+  return s << Itoa(y.Rep(ybuf));
 }
 
 std::string cvtItoa(const IntegerRep *x, std::string fmt, int& fmtlen, int base, int showbase,
@@ -2295,7 +2391,7 @@ std::istream &operator>>(std::istream &s, Integer& y)
 {
   char sgn = 0;
   char ch;
-  y.rep = Icopy_zero(y.rep);
+  y = 0L;
 
   do  {
 	 s.get(ch);
@@ -2334,7 +2430,9 @@ std::istream &operator>>(std::istream &s, Integer& y)
 
 int Integer::OK() const
 {
-  if (rep != 0)
+  if (rep == 0)
+    return val >= -LONG_MAX;
+  else
 	 {
       int l = rep->len;
       int s = rep->sgn;
@@ -2361,178 +2459,386 @@ void Integer::error(const char* msg) const
 // The following were moved from the header file to stop BC from squealing
 // endless quantities of warnings
 
-Integer::Integer() :rep(&_ZeroRep) {}
+Integer::Integer() :rep(0), val(0) {}
 
-Integer::Integer(IntegerRep* r) :rep(r) {}
+Integer::Integer(IntegerRep* r) :rep(r), val(0) { Shrink(); }
 
-Integer::Integer(int y) :rep(Icopy_long(0, (long)y)) {}
+Integer::Integer(int y) :rep(0), val(y) {}
 
-Integer::Integer(long y) :rep(Icopy_long(0, y)) {}
+Integer::Integer(long y) :rep(0), val(y)
+{
+  if (y < -LONG_MAX) rep = Icopy_long(0, y);
+}
 
-Integer::Integer(unsigned long y) :rep(Icopy_ulong(0, y)) {}
+Integer::Integer(unsigned long y) :rep(0), val((long) y)
+{
+  if (y > (unsigned long) LONG_MAX) rep = Icopy_ulong(0, y);
+}
 
-Integer::Integer(const Integer&  y) :rep(Icopy(0, y.rep)) {}
+Integer::Integer(const Integer&  y) 
+  :rep((y.rep) ? Icopy(0, y.rep) : 0), val(y.val) {}
 
 Integer::~Integer() { if (rep && !STATIC_IntegerRep(rep)) delete[] rep; }
 
 Integer &Integer::operator=(const Integer &y)
 {
-  rep = Icopy(rep, y.rep);
+  if (y.rep == 0)
+  {
+    if (rep && !STATIC_IntegerRep(rep)) delete[] rep;
+    rep = 0;
+    val = y.val;
+  }
+  else
+    rep = Icopy(rep, y.rep);
   return *this;
 }
 
 Integer &Integer::operator=(long y)
 {
-  rep = Icopy_long(rep, y); 
+  if (y < -LONG_MAX)
+    rep = Icopy_long(rep, y); 
+  else
+  {
+    if (rep && !STATIC_IntegerRep(rep)) delete[] rep;
+    rep = 0;
+    val = y;
+  }
   return *this;
 }
 
 int Integer::initialized() const
 {
-  return rep != 0;
+  return 1;
+}
+
+// small values
+
+static const IntegerRep* Irep_long(long x, LongIntegerRep& buf)
+{
+  IntegerRep* r = &buf.rep;
+  unsigned long u = Iabs_long(x);
+  int l = 0;
+  while (u != 0)
+  {
+    r->s[l++] = extract(u);
+    u >>= I_SHIFT;
+  }
+  r->len = l;
+  r->sz = 0;
+  r->sgn = (x >= 0) ? I_POSITIVE : I_NEGATIVE;
+  return r;
 }
 
-// procedural versions
+const IntegerRep* Integer::Rep(LongIntegerRep& buf) const
+{
+  return (rep) ? rep : Irep_long(val, buf);
+}
+
+void Integer::Shrink()
+{
+  if (rep == 0 || rep->len > SHORT_PER_LONG ||
+      (rep->len == SHORT_PER_LONG && rep->s[SHORT_PER_LONG - 1] >= I_MINNUM))
+    return;
+  unsigned long a = 0;
+  for (int i = rep->len - 1; i >= 0; --i)
+    a = up(a) | rep->s[i];
+  val = (rep->sgn == I_NEGATIVE) ? -(long) a : (long) a;
+  if (!STATIC_IntegerRep(rep)) delete[] rep;
+  rep = 0;
+}
+
+int Integer::fits_in_long() const
+{
+  return (rep) ? Iislong(rep) : 1;
+}
+
+int Integer::fits_in_double() const
+{
+  return (rep) ? Iisdouble(rep) : 1;
+}
+
+long Integer::as_long() const
+{
+  return (rep) ? Itolong(rep) : val;
+}
+
+double Integer::as_double() const
+{
+  if (rep == 0 && (unsigned long) (double) Iabs_long(val) == Iabs_long(val))
+    return (double) val;
+  LongIntegerRep buf;
+  return Itodouble(Rep(buf));
+}
+
+// procedural versions; each works directly on values held inline, and
+// otherwise hands representations to the routines above, moving the
+// result back inline if it fits
 
 int compare(const Integer& x, const Integer& y)
 {
-  return compare(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+    return Icompare_long(x.val, y.val);
+  LongIntegerRep xbuf, ybuf;
+  return compare(x.Rep(xbuf), y.Rep(ybuf));
 }
 
 int ucompare(const Integer& x, const Integer& y)
 {
-  return ucompare(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+  {
+    unsigned long ux = Iabs_long(x.val), uy = Iabs_long(y.val);
+    return (ux < uy) ? -1 : ((ux > uy) ? 1 : 0);
+  }
+  LongIntegerRep xbuf, ybuf;
+  return ucompare(x.Rep(xbuf), y.Rep(ybuf));
 }
 
 int compare(const Integer& x, long y)
 {
-  return compare(x.rep, y);
+  if (x.rep == 0)
+    return Icompare_long(x.val, y);
+  LongIntegerRep ybuf;
+  return compare(x.rep, Irep_long(y, ybuf));
 }
 
 int ucompare(const Integer& x, long y)
 {
-  return ucompare(x.rep, y);
+  if (x.rep == 0)
+  {
+    unsigned long ux = Iabs_long(x.val), uy = Iabs_long(y);
+    return (ux < uy) ? -1 : ((ux > uy) ? 1 : 0);
+  }
+  LongIntegerRep ybuf;
+  return ucompare(x.rep, Irep_long(y, ybuf));
 }
 
 int compare(long x, const Integer& y)
 {
-  return -compare(y.rep, x);
+  return -compare(y, x);
 }
 
 int ucompare(long x, const Integer& y)
 {
-  return -ucompare(y.rep, x);
+  return -ucompare(y, x);
 }
 
 void  add(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y.rep, 0, dest.rep);
+  long r;
+  if (x.rep == 0 && y.rep == 0 && Iadd_long(x.val, y.val, r))
+  {
+    dest = r;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = add(x.Rep(xbuf), 0, y.Rep(ybuf), 0, dest.rep);
+  dest.Shrink();
 }
 
 void  sub(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y.rep, 1, dest.rep);
+  long r;
+  if (x.rep == 0 && y.rep == 0 && Isub_long(x.val, y.val, r))
+  {
+    dest = r;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = add(x.Rep(xbuf), 0, y.Rep(ybuf), 1, dest.rep);
+  dest.Shrink();
 }
 
 void  mul(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = multiply(x.rep, y.rep, dest.rep);
+  long r;
+  if (x.rep == 0 && y.rep == 0 && Imul_long(x.val, y.val, r))
+  {
+    dest = r;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = multiply(x.Rep(xbuf), y.Rep(ybuf), dest.rep);
+  dest.Shrink();
 }
 
 void  div(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = div(x.rep, y.rep, dest.rep);
+  if (x.rep == 0 && y.rep == 0 && y.val != 0)
+  {
+    dest = x.val / y.val;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = div(x.Rep(xbuf), y.Rep(ybuf), dest.rep);
+  dest.Shrink();
 }
 
 void  mod(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y.rep, dest.rep);
+  if (x.rep == 0 && y.rep == 0 && y.val != 0)
+  {
+    dest = x.val % y.val;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = mod(x.Rep(xbuf), y.Rep(ybuf), dest.rep);
+  dest.Shrink();
 }
 
 void  lshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 0, dest.rep);
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = lshift(x.Rep(xbuf), y.Rep(ybuf), 0, dest.rep);
+  dest.Shrink();
 }
 
 void  rshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 1, dest.rep);
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = lshift(x.Rep(xbuf), y.Rep(ybuf), 1, dest.rep);
+  dest.Shrink();
 }
 
 void  pow(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = power(x.rep, Itolong(y.rep), dest.rep); // not incorrect
+  LongIntegerRep xbuf;
+  dest.rep = power(x.Rep(xbuf), y.as_long(), dest.rep); // not incorrect
+  dest.Shrink();
 }
 
 void  add(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y, dest.rep);
+  long r;
+  if (x.rep == 0 && Iadd_long(x.val, y, r))
+  {
+    dest = r;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = add(x.Rep(xbuf), 0, Irep_long(y, ybuf), 0, dest.rep);
+  dest.Shrink();
 }
 
 void  sub(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, -y, dest.rep);
+  long r;
+  if (x.rep == 0 && Isub_long(x.val, y, r))
+  {
+    dest = r;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = add(x.Rep(xbuf), 0, Irep_long(y, ybuf), 1, dest.rep);
+  dest.Shrink();
 }
 
 void  mul(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = multiply(x.rep, y, dest.rep);
+  long r;
+  if (x.rep == 0 && Imul_long(x.val, y, r))
+  {
+    dest = r;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = multiply(x.Rep(xbuf), Irep_long(y, ybuf), dest.rep);
+  dest.Shrink();
 }
 
 void  div(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = div(x.rep, y, dest.rep);
+  if (x.rep == 0 && y != 0)
+  {
+    dest = x.val / y;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = div(x.Rep(xbuf), Irep_long(y, ybuf), dest.rep);
+  dest.Shrink();
 }
 
 void  mod(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y, dest.rep);
+  if (x.rep == 0 && y != 0)
+  {
+    dest = x.val % y;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = mod(x.Rep(xbuf), Irep_long(y, ybuf), dest.rep);
+  dest.Shrink();
 }
 
 
 void  lshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y, dest.rep);
+  LongIntegerRep xbuf;
+  dest.rep = lshift(x.Rep(xbuf), y, dest.rep);
+  dest.Shrink();
 }
 
 void  rshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, -y, dest.rep);
+  LongIntegerRep xbuf;
+  dest.rep = lshift(x.Rep(xbuf), -y, dest.rep);
+  dest.Shrink();
 }
 
 void  pow(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = power(x.rep, y, dest.rep);
+  LongIntegerRep xbuf;
+  dest.rep = power(x.Rep(xbuf), y, dest.rep);
+  dest.Shrink();
 }
 
 void abs(const Integer& x, Integer& dest)
 {
+  if (x.rep == 0)
+  {
+    dest = (x.val < 0) ? -x.val : x.val;
+    return;
+  }
   dest.rep = abs(x.rep, dest.rep);
 }
 
 void negate(const Integer& x, Integer& dest)
 {
+  if (x.rep == 0)
+  {
+    dest = -x.val;
+    return;
+  }
   dest.rep = negate(x.rep, dest.rep);
 }
 
 void complement(const Integer& x, Integer& dest)
 {
-  dest.rep = Compl(x.rep, dest.rep);
+  LongIntegerRep xbuf;
+  dest.rep = Compl(x.Rep(xbuf), dest.rep);
+  dest.Shrink();
 }
 
 void  add(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(y.rep, 0, x, dest.rep);
+  add(y, x, dest);
 }
 
 void  sub(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(y.rep, 1, x, dest.rep);
+  long r;
+  if (y.rep == 0 && Isub_long(x, y.val, r))
+  {
+    dest = r;
+    return;
+  }
+  LongIntegerRep xbuf, ybuf;
+  dest.rep = add(Irep_long(x, xbuf), 0, y.Rep(ybuf), 1, dest.rep);
+  dest.Shrink();
 }
 
 void  mul(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = multiply(y.rep, x, dest.rep);
+  mul(y, x, dest);
 }
 
 // operator versions
@@ -2698,31 +3004,50 @@ void Integer::negate()
 
 int sign(const Integer& x)
 {
+  if (x.rep == 0)
+    return (x.val > 0) - (x.val < 0);
   return (x.rep->len == 0) ? 0 : ( (x.rep->sgn == 1) ? 1 : -1 );
 }
 
 int even(const Integer& y)
 {
+  if (y.rep == 0)
+    return !(Iabs_long(y.val) & 1);
   return y.rep->len == 0 || !(y.rep->s[0] & 1);
 }
 
 int odd(const Integer& y)
 {
-  return y.rep->len > 0 && (y.rep->s[0] & 1);
+  return !even(y);
 }
 
 std::string Itoa(const Integer& y, int base, int width)
 {
-  return Itoa(y.rep, base, width);
+  LongIntegerRep ybuf;
+  return Itoa(y.Rep(ybuf), base, width);
 }
 
 
 
 long lg(const Integer& x) 
 {
+  if (x.rep == 0)
+    return lg(Iabs_long(x.val));
   return lg(x.rep);
 }
 
+double frexp(const Integer& x, long& e)
+{
+  if (x.rep == 0)
+  {
+    int k;
+    double m = std::frexp((double) x.val, &k);
+    e = k;
+    return m;
+  }
+  return Ifrexp(x.rep, e);
+}
+
 // constructive operations 
 
 Integer Integer::operator+(const Integer &y) const
@@ -2872,13 +3197,28 @@ Integer  atoI(const char* s, int base)
 {
   Integer r;
   r.rep = atoIntegerRep(s, base);
+  r.Shrink();
   return r;
 }
 
 Integer  gcd(const Integer& x, const Integer& y)
 {
   Integer r;
-  r.rep = gcd(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+  {
+    unsigned long u = Iabs_long(x.val), v = Iabs_long(y.val);
+    while (v != 0)
+    {
+      unsigned long t = u % v;
+      u = v;
+      v = t;
+    }
+    r = (long) u;
+    return r;
+  }
+  LongIntegerRep xbuf, ybuf;
+  r.rep = gcd(x.Rep(xbuf), y.Rep(ybuf));
+  r.Shrink();
   return r;
 }
 
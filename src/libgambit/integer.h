@@ -44,6 +44,14 @@ struct IntegerRep                    // internal Integer representations
 // and should not be deleted by an Integer destructor.
 #define STATIC_IntegerRep(rep) ((rep)->sz==0)
 
+// Space for an IntegerRep with room for the digits of any long, so that
+// small values can be handed to the routines below without allocating
+union LongIntegerRep
+{
+  IntegerRep      rep;
+  char            space[sizeof(IntegerRep) + sizeof(long)];
+};
+
 extern IntegerRep*  Ialloc(IntegerRep*, const unsigned short *, int, int, int);
 extern IntegerRep*  Icalloc(IntegerRep*, int);
 extern IntegerRep*  Icopy_ulong(IntegerRep*, unsigned long);
@@ -81,10 +89,18 @@ extern double   Itodouble(const IntegerRep*);
 extern int      Iislong(const IntegerRep*);
 extern int      Iisdouble(const IntegerRep*);
 extern long     lg(const IntegerRep*);
+extern double   Ifrexp(const IntegerRep*, long&);
 
 class Integer {
 protected:
+  // Values of magnitude at most LONG_MAX are held in val, with rep null,
+  // so that arithmetic on them needs no allocation; all others are
+  // held in rep, and are promoted there when a result overflows val
   IntegerRep *rep;
+  long val;
+
+  const IntegerRep *Rep(LongIntegerRep &) const;  // rep, or val as one
+  void Shrink();      // move the value from rep to val if it fits
 
 public:
   /// @name Lifecycle
@@ -169,6 +185,9 @@ public:
   friend long     lg (const Integer&); // floor log base 2 of abs(x)
   friend double   ratio(const Integer& x, const Integer& y);
   // return x/y as a double
+  friend double   frexp(const Integer& x, long& e);
+  // return m, 0.5 <= |m| < 1, with x = m * 2^e to a relative error
+  // below 2^-47, in time independent of the length of x
 
   friend Integer  gcd(const Integer&, const Integer&);
   friend int      even(const Integer&); // true if even
@@ -218,11 +237,11 @@ public:
 
   // coercion & conversion
 
-  int             fits_in_long() const { return Iislong(rep); }
-  int             fits_in_double() const { return Iisdouble(rep); }
+  int             fits_in_long() const;
+  int             fits_in_double() const;
 
-  long		  as_long() const { return Itolong(rep); }
-  double	  as_double() const { return Itodouble(rep); }
+  long		  as_long() const;
+  double	  as_double() const;
 
   friend std::string Itoa(const Integer &x, int base /*= 10*/, int width /*= 0*/);
   friend Integer atoI(const char *s, int base/*= 10*/);
@@ -24,6 +24,7 @@
 #define LIBGAMBIT_MIXED_H
 
 #include "vector.h"
+#include "matrix.h"
 #include "gameagg.h"
 #include "gamebagg.h"
 
@@ -52,6 +53,14 @@ public:
   virtual T GetPayoff(int pl) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const = 0;
+  /// \brief Computes all first (and optionally second) payoff derivatives
+  ///
+  /// Only the rows of p_derivs2 for the player's own strategies are
+  /// computed.  The default implementation evaluates each derivative
+  /// separately; representations may override this with a batched
+  /// computation.
+  virtual void GetPayoffDerivs(int pl, Vector<T> &p_derivs,
+			       Matrix<T> *p_derivs2) const;
 };
 
 template <class T> class TreeMixedStrategyProfileRep 
@@ -84,6 +93,30 @@ private:
 		      int cur_pl, long index, const T &prob, T &value) const;
   //@}
 
+  /// @name Evaluation using the game's compiled payoff table
+  //@{
+  /// Offsets and probabilities of the strategies summed over, by player;
+  /// kept between evaluations so that these do not allocate
+  mutable std::vector<std::vector<long> > m_contractOffsets;
+  mutable std::vector<std::vector<T> > m_contractProbs;
+
+  /// \brief Collects the offsets and probabilities of the support
+  ///
+  /// Stores in m_contractOffsets and m_contractProbs, for each player,
+  /// the offsets and probabilities of the strategies in the support to
+  /// be summed over.  Strategies with probability zero (or not
+  /// positive, if p_positive is set) are omitted.  The strategies of
+  /// players 'fixed1' and 'fixed2', if specified, are replaced by the
+  /// single strategy given.
+  void GetContraction(bool p_positive,
+		      const GameStrategy &p_fixed1 = 0,
+		      const GameStrategy &p_fixed2 = 0) const;
+  /// Payoff to player pl, with the strategies of the specified players fixed
+  T GetTablePayoff(int pl, bool p_positive,
+		   const GameStrategy &p_fixed1 = 0,
+		   const GameStrategy &p_fixed2 = 0) const;
+  //@}
+
 public:
   TableMixedStrategyProfileRep(const StrategySupportProfile &p_support)
     : MixedStrategyProfileRep<T>(p_support)
@@ -94,6 +127,8 @@ public:
   virtual T GetPayoff(int pl) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetPayoffDerivs(int pl, Vector<T> &p_derivs,
+			       Matrix<T> *p_derivs2) const;
 };
 
 template <class T> class AggMixedStrategyProfileRep
@@ -111,6 +146,8 @@ public:
   virtual T GetPayoff(int pl) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetPayoffDerivs(int pl, Vector<T> &p_derivs,
+			       Matrix<T> *p_derivs2) const;
 };
 
 template <class T> class BagentMixedStrategyProfileRep
@@ -249,6 +286,26 @@ public:
   T GetPayoffDeriv(int pl, const GameStrategy &s1, const GameStrategy &s2) const
   { return m_rep->GetPayoffDeriv(pl, s1, s2); }
 
+  /// \brief Computes all derivatives of the player's payoff
+  ///
+  /// Computes the derivative of the payoff to the player with respect
+  /// to the probability of each strategy in the profile, as with
+  /// GetPayoffDeriv(pl, s).  The vector is indexed as the profile, and
+  /// must have length MixedProfileLength().
+  void GetPayoffDerivs(int pl, Vector<T> &p_derivs) const
+  { m_rep->GetPayoffDerivs(pl, p_derivs, 0); }
+
+  /// \brief Computes all first and second derivatives of the player's payoff
+  ///
+  /// As above, and additionally fills the rows of the square matrix
+  /// p_derivs2 for the player's own strategies s1 with the second
+  /// derivatives GetPayoffDeriv(pl, s1, s2) for each strategy s2 in the
+  /// profile.  The rows for the other players' strategies are set to
+  /// zero.  For table games, both are computed in a single pass over
+  /// the payoff table.
+  void GetPayoffDerivs(int pl, Vector<T> &p_derivs, Matrix<T> &p_derivs2) const
+  { m_rep->GetPayoffDerivs(pl, p_derivs, &p_derivs2); }
+
   /// Computes the payoff to playing the pure strategy against the profile
   T GetPayoff(const GameStrategy &p_strategy) const
   { return GetPayoffDeriv(p_strategy->GetPlayer()->GetNumber(), p_strategy); }
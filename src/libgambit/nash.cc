@@ -24,13 +24,31 @@
 
 namespace Gambit {
 
+namespace {
+
+//
+// Formats a probability or payoff to the given number of decimals.  A
+// value which rounds to zero is written without a sign, so that
+// rounding errors of either sign in a solver are reported alike.
+//
+template <class T> std::string FormatValue(const T &p_value, int p_decimals)
+{
+  std::string text = lexical_cast<std::string>(p_value, p_decimals);
+  if (text[0] == '-' && text.find_first_not_of("-0.") == std::string::npos) {
+    text.erase(0, 1);
+  }
+  return text;
+}
+
+}  // end anonymous namespace
+
 template <class T> void
 MixedStrategyCSVRenderer<T>::Render(const MixedStrategyProfile<T> &p_profile,
 				    const std::string &p_label) const
 {
   m_stream << p_label;
   for (int i = 1; i <= p_profile.MixedProfileLength(); i++) {
-    m_stream << "," << lexical_cast<std::string>(p_profile[i], m_numDecimals);
+    m_stream << "," << FormatValue(p_profile[i], m_numDecimals);
   }
   m_stream << std::endl;
 }
@@ -56,11 +74,10 @@ MixedStrategyDetailRenderer<T>::Render(const MixedStrategyProfile<T> &p_profile,
 	m_stream << std::setw(8) << strategy->GetNumber() << "    ";
       }
       m_stream << std::setw(10);
-      m_stream << lexical_cast<std::string>(p_profile[*strategy], m_numDecimals);
+      m_stream << FormatValue(p_profile[*strategy], m_numDecimals);
       m_stream << "   ";
       m_stream << std::setw(11);
-      m_stream << lexical_cast<std::string>(p_profile.GetPayoff(*strategy),
-					    m_numDecimals);
+      m_stream << FormatValue(p_profile.GetPayoff(*strategy), m_numDecimals);
       m_stream << std::endl;
     }
   }
@@ -72,7 +89,7 @@ void BehavStrategyCSVRenderer<T>::Render(const MixedBehaviorProfile<T> &p_profil
 {
   m_stream << p_label;
   for (int i = 1; i <= p_profile.Length(); i++) {
-    m_stream << "," << lexical_cast<std::string>(p_profile[i], m_numDecimals);
+    m_stream << "," << FormatValue(p_profile[i], m_numDecimals);
   }
   m_stream << std::endl;
 }
@@ -107,13 +124,12 @@ BehavStrategyDetailRenderer<T>::Render(const MixedBehaviorProfile<T> &p_profile,
 	  m_stream << std::setw(7) << action->GetNumber() << "   ";
 	}
 	m_stream << std::setw(11);
-	m_stream << lexical_cast<std::string>(p_profile(player->GetNumber(), 
-							iset, act), 
-					      m_numDecimals);
+	m_stream << FormatValue(p_profile(player->GetNumber(), iset, act),
+				m_numDecimals);
 	m_stream << "   ";
 	m_stream << std::setw(11);
-	m_stream << lexical_cast<std::string>(p_profile.GetPayoff(infoset->GetAction(act)), 
-					      m_numDecimals);
+	m_stream << FormatValue(p_profile.GetPayoff(infoset->GetAction(act)),
+				m_numDecimals);
 	m_stream << std::endl;
       }
     }
@@ -140,12 +156,12 @@ BehavStrategyDetailRenderer<T>::Render(const MixedBehaviorProfile<T> &p_profile,
 	  m_stream << std::setw(7) << node->GetNumber() << "   ";
 	}
 	m_stream << std::setw(11);
-	m_stream << lexical_cast<std::string>(p_profile.GetBeliefProb(infoset->GetMember(n)), 
-					     m_numDecimals);
+	m_stream << FormatValue(p_profile.GetBeliefProb(infoset->GetMember(n)),
+				m_numDecimals);
 	m_stream << "   ";
 	m_stream << std::setw(11);
-	m_stream << lexical_cast<std::string>(p_profile.GetRealizProb(infoset->GetMember(n)), 
-					      m_numDecimals);
+	m_stream << FormatValue(p_profile.GetRealizProb(infoset->GetMember(n)),
+				m_numDecimals);
 	m_stream << std::endl;
       }
     }
@@ -23,36 +23,122 @@
 #ifndef LIBGAMBIT_NUMBER_H
 #define LIBGAMBIT_NUMBER_H
 
+#include <cstdlib>
+
 namespace Gambit {
 
 /// This simple class stores a numerical datum.
+///
+/// Most data in practice (payoffs of large games, in particular) are
+/// integers.  Those which are written in canonical form, and are small
+/// enough to be represented exactly as a double, are stored only as a
+/// double; their exact value and text are created only when first
+/// requested.  Other data keep their text as given, and their exact
+/// value.  The deferred creation is serialized by a lock shared by all
+/// Numbers; a form is published only once it is complete, after which
+/// it is read without taking the lock.  So a Number may be read from
+/// several threads at once, though not changed while it is being read.
 class Number {
 private:
-  std::string m_text;
-  Rational m_rational;
   double m_double;
+  mutable std::string *m_text;
+  mutable Rational *m_rational;
+  bool m_isInteger;
+
+  /// Create the exact value and text of an integer, under the lock
+  void CreateRational(void) const;
+  void CreateText(void) const;
+
+  /// Returns true if the text is an integer, with no leading zeros or
+  /// plus sign, of at most 15 digits (so it is exact as a double)
+  static bool IsSmallInteger(const std::string &p_text)
+  {
+    unsigned int start = (p_text.length() > 1 && p_text[0] == '-') ? 1 : 0;
+    unsigned int digits = p_text.length() - start;
+    if (digits == 0 || digits > 15 || 
+	(p_text[start] == '0' && (digits > 1 || start == 1))) {
+      return false;
+    }
+    for (unsigned int i = start; i < p_text.length(); i++) {
+      if (p_text[i] < '0' || p_text[i] > '9')  return false;
+    }
+    return true;
+  }
+
+  void Assign(const Number &p_number)
+  {
+    m_double = p_number.m_double;
+    m_isInteger = p_number.m_isInteger;
+    // The forms of an integer created on demand are not copied, as
+    // they may be in the middle of being created
+    m_text = (!m_isInteger) ? new std::string(*p_number.m_text) : 0;
+    m_rational = (!m_isInteger) ? new Rational(*p_number.m_rational) : 0;
+  }
+
+  void Clear(void)
+  {
+    delete m_text;
+    delete m_rational;
+    m_text = 0;
+    m_rational = 0;
+  }
 
 public:
   Number(void)
-    : m_text("0"), m_rational(0), m_double(0.0) { }
+    : m_double(0.0), m_text(0), m_rational(0), m_isInteger(true) { }
   Number(const std::string &p_text)
-    : m_text(p_text), m_rational(lexical_cast<Rational>(p_text)), 
-      m_double((double) m_rational)
-  { }
+    : m_double(0.0), m_text(0), m_rational(0), m_isInteger(true)
+  { *this = p_text; }
+  Number(const Number &p_number)  { Assign(p_number); }
+  ~Number()  { Clear(); }
+
+  Number &operator=(const Number &p_number)
+  {
+    if (this != &p_number) {
+      Clear();
+      Assign(p_number);
+    }
+    return *this;
+  }
   
   Number &operator=(const std::string &p_text)
   {
+    if (IsSmallInteger(p_text)) {
+      Clear();
+      m_isInteger = true;
+      m_double = strtod(p_text.c_str(), 0);
+      return *this;
+    }
+
     // We call lexical_cast<Rational>() first because it throws a ValueException
     // if the conversion of the text fails
-    m_rational = lexical_cast<Rational>(p_text);
-    m_text = p_text;
-    m_double = (double) m_rational;
+    Rational *value = new Rational(lexical_cast<Rational>(p_text));
+    Clear();
+    m_isInteger = false;
+    m_rational = value;
+    m_text = new std::string(p_text);
+    m_double = (double) *m_rational;
     return *this; 
   }
 
+  /// Returns true if the datum is an integer stored only as a double
+  bool IsSmallInteger(void) const { return m_isInteger; }
+  /// Sets the datum to an integer of at most 15 digits, given as a double
+  void SetSmallInteger(double p_value)
+  { Clear(); m_isInteger = true; m_double = p_value; }
+
   operator const double &(void) const { return m_double; }
-  operator const Rational &(void) const { return m_rational; }
-  operator const std::string &(void) const { return m_text; }
+  // Only the forms of integers are ever missing
+  operator const Rational &(void) const 
+  {
+    if (!m_rational)  CreateRational();
+    return *m_rational;
+  }
+  operator const std::string &(void) const 
+  {
+    if (!m_text)  CreateText();
+    return *m_text;
+  }
 };
 
 }
@@ -138,13 +138,31 @@ void Rational::invert(void)
   }
 }
 
+//
+// Comparisons are filtered through floating point: x.num * y.den and
+// x.den * y.num are approximated from the leading digits of each factor,
+// and the exact products are formed only when the approximations are
+// too close to tell apart.  Each product is within a relative 2^-45 of
+// its approximation, so a relative gap above 1e-12 is certainly genuine.
+//
 int compare(const Rational& x, const Rational& y)
 {
   int xsgn = sign(x.num);
   int ysgn = sign(y.num);
   int d = xsgn - ysgn;
-  if (d == 0 && xsgn != 0) d = compare(x.num * y.den, x.den * y.num);
-  return d;
+  if (d != 0 || xsgn == 0) return d;
+
+  long e1, e2, e3, e4;
+  double m1 = fabs(frexp(x.num, e1)) * frexp(y.den, e2);
+  double m2 = frexp(x.den, e3) * fabs(frexp(y.num, e4));
+  // The mantissa products lie in [0.25, 1)
+  long e = (e1 + e2) - (e3 + e4);
+  if (e > 2) return xsgn;
+  if (e < -2) return -xsgn;
+  m1 = ldexp(m1, (int) e);
+  if (m1 - m2 > m2 * 1.0e-12) return xsgn;
+  if (m2 - m1 > m1 * 1.0e-12) return -xsgn;
+  return compare(x.num * y.den, x.den * y.num);
 }
 
 Rational::Rational(double x)
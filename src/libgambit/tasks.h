@@ -0,0 +1,115 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/tasks.h
+// Running independent tasks on worker threads
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_TASKS_H
+#define LIBGAMBIT_TASKS_H
+
+#include <vector>
+#include "libgambit.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
+
+namespace Gambit {
+
+#ifdef HAVE_PTHREAD_H
+
+/// Holds a mutex for as long as it exists
+class MutexLock {
+private:
+  pthread_mutex_t &m_mutex;
+
+public:
+  MutexLock(pthread_mutex_t &p_mutex) : m_mutex(p_mutex)
+  { pthread_mutex_lock(&m_mutex); }
+  ~MutexLock()  { pthread_mutex_unlock(&m_mutex); }
+};
+
+template <class Tasks> class TaskQueue {
+public:
+  Tasks &m_tasks;
+  int m_numTasks, m_nextTask;
+  pthread_mutex_t m_mutex;
+
+  TaskQueue(Tasks &p_tasks, int p_numTasks)
+    : m_tasks(p_tasks), m_numTasks(p_numTasks), m_nextTask(0)
+  { pthread_mutex_init(&m_mutex, 0); }
+  ~TaskQueue()  { pthread_mutex_destroy(&m_mutex); }
+
+  static void *Run(void *p_queue)
+  {
+    TaskQueue<Tasks> &queue = *static_cast<TaskQueue<Tasks> *>(p_queue);
+    while (true) {
+      pthread_mutex_lock(&queue.m_mutex);
+      int task = queue.m_nextTask++;
+      pthread_mutex_unlock(&queue.m_mutex);
+      if (task >= queue.m_numTasks) {
+	return 0;
+      }
+      queue.m_tasks(task);
+    }
+  }
+};
+
+#endif  // HAVE_PTHREAD_H
+
+///
+/// Calls p_tasks(i) for each i from 0 to p_numTasks-1, using up to
+/// p_numThreads threads, and returns once all calls have completed.
+/// Tasks are handed out in order, each to the next free thread, so
+/// p_tasks must be safe to call concurrently for different tasks, and
+/// must not throw.  Without thread support, or if no threads can be
+/// created, the tasks are run in order in the calling thread.
+///
+template <class Tasks>
+void RunTasks(Tasks &p_tasks, int p_numTasks, int p_numThreads)
+{
+#ifdef HAVE_PTHREAD_H
+  if (p_numThreads > 1 && p_numTasks > 1) {
+    TaskQueue<Tasks> queue(p_tasks, p_numTasks);
+    std::vector<pthread_t> threads(std::min(p_numThreads, p_numTasks));
+    size_t created = 0;
+    while (created < threads.size() &&
+	   pthread_create(&threads[created], 0,
+			  TaskQueue<Tasks>::Run, &queue) == 0) {
+      created++;
+    }
+    if (created == 0) {
+      // Could not create any threads; do the work in this thread
+      TaskQueue<Tasks>::Run(&queue);
+    }
+    for (size_t i = 0; i < created; i++) {
+      pthread_join(threads[i], 0);
+    }
+    return;
+  }
+#endif  // HAVE_PTHREAD_H
+
+  for (int task = 0; task < p_numTasks; task++) {
+    p_tasks(task);
+  }
+}
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_TASKS_H
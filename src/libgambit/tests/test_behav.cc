@@ -0,0 +1,158 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/tests/test_behav.cc
+// Tests of the cached quantities of behavior profiles
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include <fstream>
+
+#include "libgambit/libgambit.h"
+#include "testing.h"
+
+using namespace Gambit;
+
+namespace {
+
+bool Equal(const Rational &x, const Rational &y)  { return x == y; }
+
+bool Equal(double x, double y)
+{ return std::fabs(x - y) <= 1.0e-12 * (1.0 + std::fabs(x)); }
+
+template <class T> bool Equal(const Vector<T> &x, const Vector<T> &y)
+{
+  for (int i = 1; i <= x.Length(); i++) {
+    if (!Equal(x[i], y[i]))  return false;
+  }
+  return true;
+}
+
+void CollectNodes(const GameNode &p_node, List<GameNode> &p_nodes)
+{
+  p_nodes.push_back(p_node);
+  for (int i = 1; i <= p_node->NumChildren(); i++) {
+    CollectNodes(p_node->GetChild(i), p_nodes);
+  }
+}
+
+//
+// Checks that each quantity cached by the profile, which may have been
+// brought up to date after changes at a few information sets, equals
+// that computed from scratch by a copy of the profile.
+//
+template <class T>
+void CheckAgainstFull(const MixedBehaviorProfile<T> &p_profile)
+{
+  MixedBehaviorProfile<T> full(p_profile);
+  Game game = p_profile.GetGame();
+
+  GAMBIT_CHECK(Equal(p_profile.GetLiapValue(), full.GetLiapValue()));
+
+  List<GameNode> nodes;
+  CollectNodes(game->GetRoot(), nodes);
+  for (int i = 1; i <= nodes.Length(); i++) {
+    GAMBIT_CHECK(Equal(p_profile.GetRealizProb(nodes[i]),
+		       full.GetRealizProb(nodes[i])));
+    GAMBIT_CHECK(Equal(p_profile.GetPayoff(nodes[i]),
+		       full.GetPayoff(nodes[i])));
+  }
+
+  for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+    GAMBIT_CHECK(Equal(p_profile.GetPayoff(pl), full.GetPayoff(pl)));
+    GamePlayer player = game->GetPlayer(pl);
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      GameInfoset infoset = player->GetInfoset(iset);
+      T prob = full.GetRealizProb(infoset);
+      GAMBIT_CHECK(Equal(p_profile.GetRealizProb(infoset), prob));
+      GAMBIT_CHECK(Equal(p_profile.GetPayoff(infoset), full.GetPayoff(infoset)));
+      for (int act = 1; act <= infoset->NumActions(); act++) {
+	GameAction action = infoset->GetAction(act);
+	GAMBIT_CHECK(Equal(p_profile.GetPayoff(action), full.GetPayoff(action)));
+	GAMBIT_CHECK(Equal(p_profile.GetRegret(action), full.GetRegret(action)));
+      }
+      // Beliefs are defined only where the information set is reached
+      if (prob > (T) 0) {
+	for (int j = 1; j <= infoset->NumMembers(); j++) {
+	  GameNode member = infoset->GetMember(j);
+	  GAMBIT_CHECK(Equal(p_profile.GetBeliefProb(member),
+			     full.GetBeliefProb(member)));
+	}
+      }
+    }
+  }
+}
+
+//
+// Changes the action probabilities at a few information sets at a time,
+// more than are updated incrementally in some rounds, and checks the
+// cached quantities after each round.
+//
+template <class T>
+void TestIncrementalUpdates(const Game &p_game)
+{
+  MixedBehaviorProfile<T> profile(p_game);
+  CheckAgainstFull(profile);
+
+  for (int round = 1; round <= 20; round++) {
+    int numChanges = 1 + std::rand() % 6;
+    for (int change = 1; change <= numChanges; change++) {
+      int pl = 1 + std::rand() % p_game->NumPlayers();
+      GamePlayer player = p_game->GetPlayer(pl);
+      if (player->NumInfosets() == 0)  continue;
+      int iset = 1 + std::rand() % player->NumInfosets();
+      GameInfoset infoset = player->GetInfoset(iset);
+      for (int act = 1; act <= infoset->NumActions(); act++) {
+	// Zero probabilities leave some information sets unreached
+	profile(pl, iset, act) = (T) (std::rand() % 4) / (T) 3;
+      }
+    }
+    CheckAgainstFull(profile);
+  }
+
+  // Perturbing and restoring one action at a time, as gambit-liap does
+  // in computing gradients
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    GamePlayer player = p_game->GetPlayer(pl);
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      for (int act = 1; act <= player->GetInfoset(iset)->NumActions(); act++) {
+	profile(pl, iset, act) += (T) 1 / (T) 1000;
+	CheckAgainstFull(profile);
+	profile(pl, iset, act) -= (T) 1 / (T) 1000;
+      }
+    }
+  }
+  CheckAgainstFull(profile);
+}
+
+}  // end anonymous namespace
+
+int main(int, char **)
+{
+  const char *games[] = { "e01.efg", "e02.efg", "4cards.efg", "cent4.efg",
+			  "holdout.efg", "poker.efg", 0 };
+  std::srand(1);
+
+  for (int i = 0; games[i]; i++) {
+    std::ifstream file(GamePath(games[i]).c_str());
+    Game game = ReadGame(file);
+    TestIncrementalUpdates<double>(game);
+    TestIncrementalUpdates<Rational>(game);
+  }
+  return TestResult();
+}
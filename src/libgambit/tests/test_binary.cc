@@ -0,0 +1,185 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/tests/test_binary.cc
+// Tests of reading and writing the binary savefile format
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+
+#include "libgambit/libgambit.h"
+#include "testing.h"
+
+using namespace Gambit;
+
+namespace {
+
+//
+// Checks that the two games have the same labels and the same exact
+// payoffs in each contingency.
+//
+void CheckSameGame(const Game &p_game, const Game &p_copy)
+{
+  GAMBIT_CHECK(p_copy->GetTitle() == p_game->GetTitle());
+  GAMBIT_CHECK(p_copy->GetComment() == p_game->GetComment());
+  GAMBIT_CHECK(p_copy->NumPlayers() == p_game->NumPlayers());
+  if (p_copy->NumPlayers() != p_game->NumPlayers())  return;
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    GamePlayer player = p_game->GetPlayer(pl), copy = p_copy->GetPlayer(pl);
+    GAMBIT_CHECK(copy->GetLabel() == player->GetLabel());
+    GAMBIT_CHECK(copy->NumStrategies() == player->NumStrategies());
+    if (copy->NumStrategies() != player->NumStrategies())  return;
+    for (int st = 1; st <= player->NumStrategies(); st++) {
+      GAMBIT_CHECK(copy->GetStrategy(st)->GetLabel() ==
+		   player->GetStrategy(st)->GetLabel());
+    }
+  }
+
+  StrategyProfileIterator iter(p_game), copyIter(p_copy);
+  for (; !iter.AtEnd(); iter++, copyIter++) {
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      GAMBIT_CHECK((*copyIter)->GetPayoff(pl) == (*iter)->GetPayoff(pl));
+    }
+  }
+}
+
+std::string WriteBinary(const Game &p_game)
+{
+  std::ostringstream stream;
+  p_game->Write(stream, "binary");
+  return stream.str();
+}
+
+/// Returns true if reading the contents raises InvalidFileException
+bool IsRejected(const std::string &p_contents)
+{
+  std::istringstream stream(p_contents);
+  try {
+    ReadGame(stream);
+    return false;
+  }
+  catch (InvalidFileException &) {
+    return true;
+  }
+}
+
+//
+// Writes the game in binary, and checks that it is the same when read
+// back from a stream, and when read from a file by name, which maps it
+// into memory where that is possible.  Every truncation of the file
+// must be rejected.
+//
+void TestRoundTrip(const Game &p_game)
+{
+  std::string contents = WriteBinary(p_game);
+
+  std::istringstream stream(contents);
+  CheckSameGame(p_game, ReadGame(stream));
+
+  const char *filename = "test-binary.gbt";
+  {
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
+    file << contents;
+  }
+  CheckSameGame(p_game, ReadGame(std::string(filename)));
+  std::remove(filename);
+
+  // Writing the copy gives the same file again
+  std::istringstream again(contents);
+  GAMBIT_CHECK(WriteBinary(ReadGame(again)) == contents);
+
+  for (size_t length = 0; length < contents.size(); length++) {
+    GAMBIT_CHECK(IsRejected(contents.substr(0, length)));
+  }
+}
+
+/// A game whose payoffs include fractions, decimals, and large integers
+Game ExactPayoffGame(void)
+{
+  Array<int> dim(3);
+  dim[1] = 2;  dim[2] = 3;  dim[3] = 2;
+  Game game = NewTable(dim);
+  game->SetTitle("Exact payoffs");
+  game->SetComment("Payoffs which are not small integers are saved as text");
+  for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+    game->GetPlayer(pl)->SetLabel(std::string(pl, 'P'));
+  }
+  game->GetPlayer(2)->GetStrategy(3)->SetLabel("");
+
+  const char *values[] = { "0", "-7", "1/3", "-5/2", "0.125",
+			   "123456789012345678901234567890", "1000000000000000",
+			   "-999999999999999", 0 };
+  int i = 0;
+  for (StrategyProfileIterator iter(game); !iter.AtEnd(); iter++) {
+    for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+      if (!values[i])  i = 0;
+      (*iter)->GetOutcome()->SetPayoff(pl, values[i++]);
+    }
+  }
+  return game;
+}
+
+/// Replaces the integer field at the offset, in the native byte order
+template <class T>
+std::string SetField(const std::string &p_contents, size_t p_offset, T p_value)
+{
+  std::string contents(p_contents);
+  std::memcpy(&contents[p_offset], &p_value, sizeof(T));
+  return contents;
+}
+
+void TestInvalidFiles(void)
+{
+  std::string contents = WriteBinary(ExactPayoffGame());
+
+  // The header is the tag, the version, a byte order mark, the number of
+  // players, a reserved word, the number of exact payoffs, and then the
+  // numbers of strategies
+  size_t version = 8, order = 12, players = 16, numExact = 24, strategies = 32;
+  GAMBIT_CHECK(IsRejected(SetField(contents, version, (uint32_t) 99)));
+  GAMBIT_CHECK(IsRejected(SetField(contents, order, (uint32_t) 0x04030201)));
+  GAMBIT_CHECK(IsRejected(SetField(contents, players, (uint32_t) 0)));
+  GAMBIT_CHECK(IsRejected(SetField(contents, strategies, (uint32_t) 0)));
+  GAMBIT_CHECK(IsRejected(SetField(contents, strategies, (uint32_t) 1000000)));
+  // More exact payoffs than are stored run off the end of the file
+  GAMBIT_CHECK(IsRejected(SetField(contents, numExact, (uint64_t) 100)));
+
+  // The last exact payoff is made into text which is not a number
+  std::string notNumber(contents);
+  notNumber[notNumber.size() - 1] = 'x';
+  GAMBIT_CHECK(IsRejected(notNumber));
+}
+
+}  // end anonymous namespace
+
+int main(int, char **)
+{
+  const char *games[] = { "e02.nfg", "2x2x2.nfg", "8x8.nfg", "g3.nfg",
+			  "yamamoto.nfg", 0 };
+  for (int i = 0; games[i]; i++) {
+    std::ifstream file(GamePath(games[i]).c_str());
+    TestRoundTrip(ReadGame(file));
+  }
+  TestRoundTrip(ExactPayoffGame());
+  TestInvalidFiles();
+  return TestResult();
+}
@@ -0,0 +1,176 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/tests/test_integer.cc
+// Tests of Integer arithmetic at the edges of the inline representation
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <climits>
+#include <sstream>
+#include <vector>
+
+#include "libgambit/libgambit.h"
+#include "testing.h"
+
+using namespace Gambit;
+
+namespace {
+
+std::string ToText(const Integer &x)
+{
+  std::ostringstream s;
+  s << x;
+  return s.str();
+}
+
+Integer FromText(const std::string &p_text)
+{
+  std::istringstream s(p_text);
+  Integer x;
+  s >> x;
+  return x;
+}
+
+/// The result of compare() is meaningful only in its sign
+int Sign(int p_compare)
+{ return (p_compare > 0) - (p_compare < 0); }
+
+//
+// Values on both sides of the boundaries of the inline representation,
+// which holds values in [-LONG_MAX, LONG_MAX], and of the products which
+// can be formed without overflow.
+//
+std::vector<Integer> EdgeValues(void)
+{
+  std::vector<long> values;
+  // Products of values below halfWord in magnitude fit in a long
+  long halfWord = 1L << (sizeof(long) * 4);
+  long edges[] = { 0, 1, 2, 3, 7, halfWord / 2 - 1, halfWord / 2,
+		   halfWord - 1, halfWord, halfWord + 1,
+		   LONG_MAX / 3, LONG_MAX / 2, LONG_MAX - 1, LONG_MAX };
+  for (size_t i = 0; i < sizeof(edges) / sizeof(long); i++) {
+    values.push_back(edges[i]);
+    if (edges[i] != 0)  values.push_back(-edges[i]);
+  }
+
+  std::vector<Integer> result;
+  for (size_t i = 0; i < values.size(); i++) {
+    result.push_back(Integer(values[i]));
+  }
+  result.push_back(Integer(LONG_MIN));
+  result.push_back(Integer(LONG_MAX) + Integer(1));
+  result.push_back(Integer(LONG_MIN) - Integer(1));
+  result.push_back(Integer(LONG_MAX) * Integer(LONG_MAX));
+  result.push_back(-(Integer(LONG_MAX) * Integer(3)));
+  return result;
+}
+
+//
+// Each operation is checked against the same operation on the values
+// scaled by a power of two beyond the inline range, which is carried
+// out entirely on the allocated representation.
+//
+void TestOperations(const Integer &x, const Integer &y)
+{
+  Integer scale = Integer(1) << 80L;
+  Integer xs = x * scale, ys = y * scale;
+
+  GAMBIT_CHECK((x + y) * scale == xs + ys);
+  GAMBIT_CHECK((x - y) * scale == xs - ys);
+  GAMBIT_CHECK((x * y) * scale == xs * y);
+  GAMBIT_CHECK((x * y) * scale * scale == xs * ys);
+  GAMBIT_CHECK(Sign(compare(x, y)) == Sign(compare(xs, ys)));
+  GAMBIT_CHECK((x < y) == (xs < ys));
+  GAMBIT_CHECK((x == y) == (xs == ys));
+  GAMBIT_CHECK(gcd(x, y) * scale == gcd(xs, ys));
+  if (sign(y) != 0) {
+    GAMBIT_CHECK(x / y == xs / ys);
+    GAMBIT_CHECK((x % y) * scale == xs % ys);
+    GAMBIT_CHECK((x / y) * y + x % y == x);
+  }
+
+  // The procedural and assignment forms, including with aliasing
+  Integer z;
+  add(x, y, z);   GAMBIT_CHECK(z * scale == xs + ys);
+  sub(x, y, z);   GAMBIT_CHECK(z * scale == xs - ys);
+  mul(x, y, z);   GAMBIT_CHECK(z * scale == xs * y);
+  z = x;  z += y;  GAMBIT_CHECK(z * scale == xs + ys);
+  z = x;  z -= y;  GAMBIT_CHECK(z * scale == xs - ys);
+  z = x;  z *= y;  GAMBIT_CHECK(z * scale == xs * y);
+  z = x;  z += z;  GAMBIT_CHECK(z * scale == xs + xs);
+  z = x;  z *= z;  GAMBIT_CHECK(z * scale * scale == xs * xs);
+
+  // The forms taking a long, where y is one
+  if (y.fits_in_long()) {
+    long l = y.as_long();
+    GAMBIT_CHECK((x + l) * scale == xs + ys);
+    GAMBIT_CHECK((x - l) * scale == xs - ys);
+    GAMBIT_CHECK((x * l) * scale == xs * y);
+    GAMBIT_CHECK(Sign(compare(x, l)) == Sign(compare(xs, ys)));
+    if (l != 0) {
+      GAMBIT_CHECK(x / l == xs / ys);
+      GAMBIT_CHECK((x % l) * scale == xs % ys);
+    }
+  }
+}
+
+void TestConversions(const Integer &x)
+{
+  GAMBIT_CHECK(FromText(ToText(x)) == x);
+  GAMBIT_CHECK(-(-x) == x);
+  GAMBIT_CHECK(abs(x) == ((sign(x) < 0) ? -x : x));
+  if (x.fits_in_long()) {
+    GAMBIT_CHECK(Integer(x.as_long()) == x);
+  }
+}
+
+void TestKnownValues(void)
+{
+  std::ostringstream max, min, maxPlusOne;
+  max << LONG_MAX;
+  min << LONG_MIN;
+  maxPlusOne << (unsigned long) LONG_MAX + 1UL;
+
+  GAMBIT_CHECK(ToText(Integer(LONG_MAX)) == max.str());
+  GAMBIT_CHECK(ToText(Integer(LONG_MIN)) == min.str());
+  GAMBIT_CHECK(ToText(Integer(LONG_MAX) + Integer(1)) == maxPlusOne.str());
+  GAMBIT_CHECK(ToText(-Integer(LONG_MIN)) == maxPlusOne.str());
+  GAMBIT_CHECK(ToText(Integer(LONG_MIN) / Integer(-1)) == maxPlusOne.str());
+  GAMBIT_CHECK(Integer(LONG_MAX) + Integer(1) - Integer(1) == Integer(LONG_MAX));
+  GAMBIT_CHECK((Integer(LONG_MAX) + Integer(1)).fits_in_long() == 0);
+  GAMBIT_CHECK(Integer(-LONG_MAX).fits_in_long() != 0);
+  Integer big = (Integer(123456789012345L) * Integer(1000000000000000L) +
+		 Integer(678901234567890L));
+  GAMBIT_CHECK(FromText("123456789012345678901234567890") == big);
+  GAMBIT_CHECK(FromText("-123456789012345678901234567890") == -big);
+}
+
+}  // end anonymous namespace
+
+int main(int, char **)
+{
+  std::vector<Integer> values = EdgeValues();
+  for (size_t i = 0; i < values.size(); i++) {
+    TestConversions(values[i]);
+    for (size_t j = 0; j < values.size(); j++) {
+      TestOperations(values[i], values[j]);
+    }
+  }
+  TestKnownValues();
+  return TestResult();
+}
@@ -0,0 +1,127 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/tests/test_rational.cc
+// Tests of comparing Rationals through floating-point approximations
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "libgambit/libgambit.h"
+#include "testing.h"
+
+using namespace Gambit;
+
+namespace {
+
+/// The result of compare() is meaningful only in its sign
+int Sign(int p_compare)
+{ return (p_compare > 0) - (p_compare < 0); }
+
+//
+// Integers of one word and of several, up to beyond the range of a
+// double, of either sign.
+//
+std::vector<Integer> TestValues(void)
+{
+  long words[] = { 1, 2, 3, 7, 1000, 65535, 65536, 123456789,
+		   LONG_MAX / 3, LONG_MAX };
+  std::vector<Integer> values;
+  for (size_t i = 0; i < sizeof(words) / sizeof(long); i++) {
+    for (long shift = 0; shift <= 2100; shift += 700) {
+      Integer x = Integer(words[i]) << shift;
+      values.push_back(x);
+      values.push_back(-x);
+    }
+  }
+  return values;
+}
+
+//
+// frexp() approximates from the leading digits only, so the mantissa
+// must be within a relative 2^-47 of the value, and shifting the value
+// must change only the exponent.
+//
+void TestFrexp(void)
+{
+  long words[] = { 1, 3, 1000, 65537, 123456789, 9007199254740991L };
+  for (size_t i = 0; i < sizeof(words) / sizeof(long); i++) {
+    long e;
+    double m = frexp(Integer(words[i]), e);
+    GAMBIT_CHECK(std::fabs(m) >= 0.5 && std::fabs(m) < 1.0);
+    GAMBIT_CHECK(std::fabs(std::ldexp(m, (int) e) - (double) words[i]) <=
+		 (double) words[i] * std::ldexp(1.0, -47));
+
+    for (long shift = 100; shift <= 3000; shift += 700) {
+      long es;
+      double ms = frexp(-(Integer(words[i]) << shift), es);
+      GAMBIT_CHECK(std::fabs(ms + m) <= std::ldexp(1.0, -47));
+      GAMBIT_CHECK(es == e + shift);
+    }
+  }
+
+  long e;
+  GAMBIT_CHECK(frexp(Integer(0), e) == 0.0);
+}
+
+//
+// Comparisons are decided from the approximations of the cross
+// products, unless these are too close; the result must always agree
+// with the sign of the exact difference.
+//
+void TestCompare(void)
+{
+  std::vector<Integer> values = TestValues();
+  for (size_t i = 0; i < values.size(); i++) {
+    for (size_t j = 0; j < values.size(); j++) {
+      Rational x(values[i], values[j]);
+      // Near-ties, which the approximations cannot separate
+      Rational y(values[i] * Integer(1000000) + Integer(1),
+		 values[j] * Integer(1000000));
+      Rational z(values[i] * Integer(LONG_MAX), values[j] * Integer(LONG_MAX));
+      GAMBIT_CHECK(Sign(compare(x, y)) == sign(x - y));
+      GAMBIT_CHECK(Sign(compare(y, x)) == sign(y - x));
+      GAMBIT_CHECK(compare(x, z) == 0);
+      GAMBIT_CHECK((x < y) == (sign(y - x) > 0));
+      GAMBIT_CHECK(x == z);
+    }
+  }
+
+  // Random operands, many of them near-ties
+  for (int n = 0; n < 20000; n++) {
+    Integer a = Integer(std::rand()) << (long) (std::rand() % 200);
+    Integer b = Integer(std::rand() + 1) << (long) (std::rand() % 200);
+    Integer c = a * Integer(std::rand() % 3 + 1) + Integer(std::rand() % 3 - 1);
+    Integer d = b * Integer(std::rand() % 3 + 1);
+    Rational x(a, b), y(c, d);
+    GAMBIT_CHECK(Sign(compare(x, y)) == sign(x - y));
+  }
+}
+
+}  // end anonymous namespace
+
+int main(int, char **)
+{
+  std::srand(1);
+  TestFrexp();
+  TestCompare();
+  return TestResult();
+}
@@ -0,0 +1,111 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/tests/test_table.cc
+// Tests of checking pure profiles against tables of best payoffs
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include "libgambit/libgambit.h"
+#include "testing.h"
+
+using namespace Gambit;
+
+namespace {
+
+//
+// A game with payoffs drawn from values which are equal, or distinct
+// but equal or in the wrong order once rounded to doubles, so that the
+// tables of best payoffs as doubles cannot decide between them.
+//
+Game NearTieGame(int p_numStrategies1, int p_numStrategies2,
+		 int p_numStrategies3)
+{
+  Array<int> dim(3);
+  dim[1] = p_numStrategies1;
+  dim[2] = p_numStrategies2;
+  dim[3] = p_numStrategies3;
+  Game game = NewTable(dim);
+
+  const char *values[] = { "0", "1", "2", "1/3",
+			   "333333333333333333/1000000000000000000",
+			   "333333333333333334/1000000000000000000",
+			   "123456789012345678901", "123456789012345678902",
+			   "1/100000000000000000000000000000",
+			   "2/100000000000000000000000000000",
+			   "-1/7", 0 };
+  int numValues = 0;
+  while (values[numValues])  numValues++;
+  for (StrategyProfileIterator iter(game); !iter.AtEnd(); iter++) {
+    for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+      // Few values, so that best responses are common
+      (*iter)->GetOutcome()->SetPayoff(pl, values[std::rand() % numValues]);
+    }
+  }
+  return game;
+}
+
+//
+// Checks that each contingency is an equilibrium, and a best response
+// for each player, when checked against the tables exactly when it is
+// when checked by evaluating each deviation exactly.
+//
+void TestAgainstDeviations(const Game &p_game)
+{
+  std::vector<bool> nash;
+  std::vector<std::vector<bool> > best;
+  p_game->SetCompiledPayoffs(false);
+  for (StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++) {
+    nash.push_back((*iter)->IsNash());
+    best.push_back(std::vector<bool>());
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      best.back().push_back((*iter)->IsBestResponse(p_game->GetPlayer(pl)));
+    }
+  }
+
+  p_game->SetCompiledPayoffs(true);
+  size_t i = 0;
+  for (StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++, i++) {
+    GAMBIT_CHECK((*iter)->IsNash() == nash[i]);
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      GAMBIT_CHECK((*iter)->IsBestResponse(p_game->GetPlayer(pl)) ==
+		   best[i][pl-1]);
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+int main(int, char **)
+{
+  std::srand(1);
+  for (int i = 0; i < 20; i++) {
+    TestAgainstDeviations(NearTieGame(1 + i % 4, 2 + i % 3, 3));
+  }
+
+  const char *games[] = { "e02.nfg", "2x2x2.nfg", "8x8.nfg", "g3.nfg",
+			  "yamamoto.nfg", 0 };
+  for (int i = 0; games[i]; i++) {
+    std::ifstream file(GamePath(games[i]).c_str());
+    TestAgainstDeviations(ReadGame(file));
+  }
+  return TestResult();
+}
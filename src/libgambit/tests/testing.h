@@ -0,0 +1,79 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/tests/testing.h
+// Minimal support for the unit test programs
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_TESTS_TESTING_H
+#define LIBGAMBIT_TESTS_TESTING_H
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//
+// The tests in src/python/gambit/tests exercise the library through
+// the Python extension, which only exposes games, profiles and the
+// solvers' results.  The C++ test programs cover the internals which
+// are not exposed there, such as the Integer representation, the LU
+// factors of a basis, or the distributions of an action graph game,
+// and run without the Python extension being built.
+//
+// Each test program is a single translation unit, which reports each
+// failed check as it happens, and exits with the status returned by
+// TestResult().  The programs are run by "make check".
+//
+
+namespace {
+
+int g_numChecks = 0, g_numFailures = 0;
+
+void CheckCondition(bool p_condition, const char *p_text,
+		    const char *p_file, int p_line)
+{
+  g_numChecks++;
+  if (!p_condition) {
+    g_numFailures++;
+    std::cerr << p_file << ":" << p_line << ": check failed: "
+	      << p_text << std::endl;
+  }
+}
+
+/// Returns the path of a game in contrib/games of the source tree
+std::string GamePath(const std::string &p_name)
+{
+  // The test driver sets srcdir to the top of the source tree
+  const char *srcdir = std::getenv("srcdir");
+  return std::string((srcdir) ? srcdir : ".") + "/contrib/games/" + p_name;
+}
+
+/// Prints a summary, and returns the exit status of the program
+int TestResult(void)
+{
+  std::cerr << g_numChecks - g_numFailures << " of " << g_numChecks
+	    << " checks passed" << std::endl;
+  return (g_numFailures == 0) ? 0 : 1;
+}
+
+}  // end anonymous namespace
+
+#define GAMBIT_CHECK(condition) \
+  CheckCondition((condition), #condition, __FILE__, __LINE__)
+
+#endif  // LIBGAMBIT_TESTS_TESTING_H
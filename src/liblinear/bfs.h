@@ -58,13 +58,9 @@ public:
     m_map.insert(std::pair<int, T>(key, value));
   }
 
-  const T &operator[](int key) {
-    if (m_map.count(key) == 1) {
-      return m_map[key];
-    }
-    else {
-      return m_default;
-    }
+  const T &operator[](int key) const {
+    typename std::map<int, T>::const_iterator iter = m_map.find(key);
+    return (iter != m_map.end()) ? (*iter).second : m_default;
   }
 };
 
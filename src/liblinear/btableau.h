@@ -100,6 +100,9 @@ public:
   Basis & GetBasis(void);
   const Gambit::Matrix<T> & Get_A(void) const;
   const Gambit::Vector<T> & Get_b(void) const;
+  // use a new matrix of the same dimensions; the tableau must then be
+  // refactored before it is used
+  void SetMatrix(const Gambit::Matrix<T> &);
   
   bool Member(int i) const;
   int Label(int i) const;   // return variable in i'th position of Tableau
@@ -23,6 +23,7 @@
 #ifndef LUDECOMP_H
 #define LUDECOMP_H
 
+#include <vector>
 #include "libgambit/libgambit.h"
 #include "basis.h"
 
@@ -32,24 +33,38 @@ template <class T> class Tableau;
 // Class EtaMatrix
 // ---------------------------------------------------------------------------
 
+//
+// An identity matrix with one column replaced.  Only the nonzero
+// entries off the diagonal are stored.  The factors L and U are kept
+// in the same form: a column of L holds the multipliers of one pivot,
+// and a row of U the entries of the pivot row.
+//
 template <class T> class EtaMatrix {
   public:
   int col;
-  Gambit::Vector<T> etadata;
-  
+  T pivot;                    // the entry in position col
+  std::vector<int> index;     // positions of the other nonzero entries
+  std::vector<T> value;       // and their values
   
-  EtaMatrix(int c, Gambit::Vector<T> &v) : col(c), etadata(v) {};
-
-// required for list class
-bool operator==(const EtaMatrix<T> &) const;
-bool operator!=(const EtaMatrix<T> &) const;
+  EtaMatrix(int c, const T &p) : col(c), pivot(p) {};
+  EtaMatrix(int c, const Gambit::Vector<T> &v);
 
+  int NumNonzeros(void) const { return index.size() + 1; }
 };
 
 // ---------------------------------------------------------------------------
 // Class LUdecomp
 // ---------------------------------------------------------------------------
 
+//
+// The basis matrix is factored as B = L U, up to permutations of rows
+// and columns, by sparse Gaussian elimination.  Pivots are chosen by
+// the Markowitz criterion, among entries which are not much smaller
+// than the largest in their column, to limit the fill-in.  Changes of
+// basis are kept as a file of eta matrices, and the basis is refactored
+// once solving through the growing eta file costs more, per iteration,
+// than refactoring would.
+//
 template <class T> class LUdecomp {
 
 private:
@@ -57,21 +72,31 @@ private:
   Tableau<T> &tab;
   Basis &basis;
 
-  Gambit::List< EtaMatrix<T> > L;
-  Gambit::List< EtaMatrix<T> > U;
-  Gambit::List< EtaMatrix<T> > E;
-  Gambit::List< int > P;
+  std::vector< EtaMatrix<T> > L;
+  std::vector< EtaMatrix<T> > U;
+  std::vector< EtaMatrix<T> > E;
 
   Gambit::Vector<T> scratch1; // scratch vectors so we don't reallocate them
   Gambit::Vector<T> scratch2; // everytime we do something.
+  // the solves through the factors work in the scratch vector of the
+  // decomposition being solved, which is passed on to its parent: copies
+  // of this decomposition may be solving through it on other threads
+  mutable Gambit::Vector<T> scratch3;
 
   int refactor_number;
   int iterations;
-  int total_operations;
+  // operation counts: the nonzeros in the factors and in the eta file,
+  // and the work done since the last refactoring, including the
+  // factoring itself
+  long factor_size, eta_size, total_operations;
 
   const LUdecomp<T> *parent;
   int copycount;
 
+  // copies may be made, refactored and deleted on different threads,
+  // so the count of copies is changed under a lock
+  void ChangeCopyCount(int) const;
+
   // don't use this copy constructor
   LUdecomp( const LUdecomp<T> &a);
   // don't use the equals operator, use the Copy function instead
@@ -141,41 +166,21 @@ private:
   
   void FactorBasis();
 
-  void GaussElem( Gambit::Matrix<T> &, int, int );
-
-  bool CheckBasis();
   bool RefactorCheck();
 
+  // solve and solveT, working in the given scratch vector
+  void solve( const Gambit::Vector<T> &, Gambit::Vector<T> &,
+	      Gambit::Vector<T> & ) const;
+  void solveT( const Gambit::Vector<T> &, Gambit::Vector<T> &,
+	       Gambit::Vector<T> & ) const;
+
   void BTransE( Gambit::Vector<T> & ) const;
   void FTransE( Gambit::Vector<T> & ) const;
-  void BTransU( Gambit::Vector<T> & ) const;
-  void FTransU( Gambit::Vector<T> & ) const;
-  void LPd_Trans( Gambit::Vector<T> & ) const;
-  void yLP_Trans( Gambit::Vector<T> & ) const;
-
-  void VectorEtaSolve( const Gambit::Vector<T> &v,  
-		      const EtaMatrix<T> &, 
-		      Gambit::Vector<T> &y ) const;
-
-  void EtaVectorSolve( const Gambit::Vector<T> &v, 
-		      const EtaMatrix<T> &,
-		      Gambit::Vector<T> &d ) const;
-
-  void yLP_mult( const Gambit::Vector<T> &y, int j, Gambit::Vector<T> &) const;
-
-  void LPd_mult( Gambit::Vector<T> &d, int j, Gambit::Vector<T> &) const;
-
+  void FTransLU( const Gambit::Vector<T> &, Gambit::Vector<T> &,
+		 Gambit::Vector<T> & ) const;
+  void BTransLU( const Gambit::Vector<T> &, Gambit::Vector<T> &,
+		 Gambit::Vector<T> & ) const;
 
 };  // end of class LUdecomp
     
 #endif // LUDECOMP_H
-
-
-
-
-
-
-
-
-
-
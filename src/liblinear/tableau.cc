@@ -350,15 +350,31 @@ void Tableau<Gambit::Rational>::Pivot(int outrow,int in_col)
   // 4: d=Ci*j* (done last)
 
   // Step 3
+  // The divisions by d are exact.  Rows with a zero in column j* only
+  // need scaling, which saves a product per entry in sparse tableaus.
   
+  Gambit::Integer pivot = Tabdat(row,col), factor, tmp;
   for(i=Tabdat.MinRow();i<=Tabdat.MaxRow();++i){
     if(i!=row){
+      factor = Tabdat(i,col);
+      bool sparse = (sign(factor) == 0);
       for(j=Tabdat.MinCol();j<=Tabdat.MaxCol();++j){
 	if(j!=col){
-	  Tabdat(i,j) = (Tabdat(row,col)*Tabdat(i,j)-Tabdat(row,j)*Tabdat(i,col))/denom;
+	  Gambit::Integer &entry = Tabdat(i,j);
+	  mul(entry, pivot, entry);
+	  if(!sparse) {
+	    mul(Tabdat(row,j), factor, tmp);
+	    sub(entry, tmp, entry);
+	  }
+	  div(entry, denom, entry);
 	}
       }
-      Coeff[i] = (Tabdat(row,col)*Coeff[i]-Coeff[row]*Tabdat(i,col))/denom;
+      mul(Coeff[i], pivot, Coeff[i]);
+      if(!sparse) {
+	mul(Coeff[row], factor, tmp);
+	sub(Coeff[i], tmp, Coeff[i]);
+      }
+      div(Coeff[i], denom, Coeff[i]);
     }
   }
   // Step 2
@@ -393,20 +409,27 @@ void Tableau<Gambit::Rational>::Pivot(int outrow,int in_col)
 void Tableau<Gambit::Rational>::SolveColumn(int in_col, Gambit::Vector<Gambit::Rational> &out)
 {
   Gambit::Vector<Gambit::Integer> tempcol(tmpcol.First(),tmpcol.Last());
+  SolveColumn(in_col,tempcol);
+  Gambit::Integer d = abs(denom)*totdenom;
+  for(int i=out.First();i<=out.Last();i++) 
+    out[i] = Gambit::Rational(tempcol[i],d);
+}
+
+void Tableau<Gambit::Rational>::SolveColumn(int in_col, Gambit::Vector<Gambit::Integer> &out) const
+{
   if(Member(in_col)) {
-    out = (Gambit::Rational)0;
-    out[Find(in_col)] = Gambit::Rational(abs(denom));
+    out = (Gambit::Integer)0;
+    out[Find(in_col)] = abs(denom)*totdenom;
+    return;
   }
-  else {
-    int col = remap(in_col);
-    Tabdat.GetColumn(col,tempcol);
-    for(int i=tempcol.First();i<=tempcol.Last();i++)
-      out[i] = (Gambit::Rational)(tempcol[i]) * (Gambit::Rational)(sign(denom*totdenom));
-  }
-  out=out/(Gambit::Rational)abs(denom);
-  if(in_col < 0) out*=totdenom;
+  Tabdat.GetColumn(remap(in_col),out);
+  // In the rational form, a column of A is scaled by totdenom, and a
+  // row of an artificial variable divided by it
+  Gambit::Integer scale = sign(denom*totdenom);
+  if(in_col < 0) scale *= totdenom;
+  Gambit::Integer rowscale = scale*totdenom;
   for(int i=out.First();i<=out.Last();i++) 
-    if(Label(i)<0) out[i]=(Gambit::Rational)out[i]/(Gambit::Rational)totdenom;
+    out[i] *= (Label(i)<0) ? scale : rowscale;
 }
 
 void Tableau<Gambit::Rational>::MySolveColumn(int in_col, Gambit::Vector<Gambit::Rational> &out)
@@ -527,10 +550,19 @@ bool Tableau<Gambit::Rational>::IsLexMin()
 
 void Tableau<Gambit::Rational>::BasisVector(Gambit::Vector<Gambit::Rational> &out) const
 {
-  out = solution;
-  out= out/(Gambit::Rational)abs(denom) ;
+  Gambit::Vector<Gambit::Integer> tempcol(solution.First(),solution.Last());
+  BasisVector(tempcol);
+  Gambit::Integer d = abs(denom)*totdenom;
   for(int i=out.First();i<=out.Last();i++) 
-    if(Label(i)<0) out[i]=out[i]/(Gambit::Rational)totdenom;
+    out[i] = Gambit::Rational(tempcol[i],d);
+}
+
+void Tableau<Gambit::Rational>::BasisVector(Gambit::Vector<Gambit::Integer> &out) const
+{
+  for(int i=out.First();i<=out.Last();i++) {
+    out[i] = solution[i].numerator();
+    if(Label(i)>=0) out[i] *= totdenom;
+  }
 }
 
 Gambit::Integer Tableau<Gambit::Rational>::TotDenom() const
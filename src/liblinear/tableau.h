@@ -79,6 +79,11 @@ private:
 
 // 
 // Tableau<Gambit::Rational> 
+//
+// The tableau is kept fraction-free, as integers over a common
+// denominator.  Its entries are subdeterminants of the original matrix,
+// which soon outgrow a machine word, and the entries after each pivot
+// are computed from those before it, so all of its arithmetic is exact.
 //  
 
 template<>
@@ -134,6 +139,13 @@ public:
   bool IsLexMin();
   void BasisVector(Gambit::Vector<Gambit::Rational> &out) const;
   Gambit::Integer TotDenom() const;
+
+  // Fraction-free versions of SolveColumn and BasisVector.  The entries 
+  // are numerators over the common denominator abs(denom) * totdenom,
+  // so they can be compared, or the ratios of entries in the same row
+  // compared, without normalizing any fractions.
+  void SolveColumn(int, Gambit::Vector<Gambit::Integer> &) const;
+  void BasisVector(Gambit::Vector<Gambit::Integer> &) const;
 };
 
 #endif     // TABLEAU_H
@@ -0,0 +1,194 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/tests/test_ludecomp.cc
+// Tests of solving through the sparse LU decomposition of a basis
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include <cstdlib>
+
+#include "libgambit/libgambit.h"
+#include "liblinear/tableau.h"
+#include "libgambit/tests/testing.h"
+
+using namespace Gambit;
+
+namespace {
+
+double RandomEntry(void)
+{
+  return (double) (std::rand() % 19 - 9) / (double) (1 + std::rand() % 4);
+}
+
+/// A random matrix with about the given fraction of its entries nonzero
+Matrix<double> RandomMatrix(int n, double p_density)
+{
+  Matrix<double> A(1, n, 1, n);
+  for (int i = 1; i <= n; i++) {
+    for (int j = 1; j <= n; j++) {
+      A(i, j) = ((double) std::rand() / RAND_MAX < p_density) ?
+	RandomEntry() : 0.0;
+    }
+  }
+  return A;
+}
+
+Vector<double> RandomVector(int n)
+{
+  Vector<double> v(1, n);
+  for (int i = 1; i <= n; i++)  v[i] = RandomEntry();
+  return v;
+}
+
+/// The current basis matrix of the tableau, as a dense matrix
+Matrix<double> BasisMatrix(const Tableau<double> &p_tableau)
+{
+  int n = p_tableau.MaxRow();
+  Matrix<double> B(1, n, 1, n);
+  Vector<double> column(1, n);
+  for (int j = 1; j <= n; j++) {
+    p_tableau.GetColumn(p_tableau.Label(j), column);
+    for (int i = 1; i <= n; i++)  B(i, j) = column[i];
+  }
+  return B;
+}
+
+/// Solves B x = b by Gaussian elimination with partial pivoting
+Vector<double> DenseSolve(Matrix<double> B, Vector<double> b)
+{
+  int n = b.Length();
+  for (int k = 1; k <= n; k++) {
+    int pivot = k;
+    for (int i = k + 1; i <= n; i++) {
+      if (std::fabs(B(i, k)) > std::fabs(B(pivot, k)))  pivot = i;
+    }
+    B.SwitchRows(k, pivot);
+    std::swap(b[k], b[pivot]);
+    for (int i = k + 1; i <= n; i++) {
+      double factor = B(i, k) / B(k, k);
+      for (int j = k; j <= n; j++)  B(i, j) -= factor * B(k, j);
+      b[i] -= factor * b[k];
+    }
+  }
+  Vector<double> x(1, n);
+  for (int i = n; i >= 1; i--) {
+    x[i] = b[i];
+    for (int j = i + 1; j <= n; j++)  x[i] -= B(i, j) * x[j];
+    x[i] /= B(i, i);
+  }
+  return x;
+}
+
+bool Close(const Vector<double> &x, const Vector<double> &y)
+{
+  for (int i = x.First(); i <= x.Last(); i++) {
+    if (std::fabs(x[i] - y[i]) > 1.0e-8 * (1.0 + std::fabs(y[i])))  return false;
+  }
+  return true;
+}
+
+//
+// Checks the solutions of B x = b, B x = c and y B = c through the
+// factorization against dense solves with the current basis B.
+//
+void CheckSolves(Tableau<double> &p_tableau, const Vector<double> &p_b)
+{
+  int n = p_b.Length();
+  Matrix<double> B = BasisMatrix(p_tableau);
+  Vector<double> x(1, n), c = RandomVector(n), y(1, n);
+
+  p_tableau.BasisVector(x);
+  GAMBIT_CHECK(Close(x, DenseSolve(B, p_b)));
+  p_tableau.Solve(c, y);
+  GAMBIT_CHECK(Close(y, DenseSolve(B, c)));
+  p_tableau.SolveT(c, y);
+  GAMBIT_CHECK(Close(y, DenseSolve(B.Transpose(), c)));
+}
+
+//
+// Brings column j into the basis in place of the slack column with the
+// largest entry in the solved column, if there is one.
+//
+bool PivotIn(Tableau<double> &p_tableau, int j)
+{
+  int n = p_tableau.MaxRow();
+  Vector<double> column(1, n);
+  p_tableau.SolveColumn(j, column);
+  int row = 0;
+  for (int i = 1; i <= n; i++) {
+    if (p_tableau.Label(i) < 0 &&
+	std::fabs(column[i]) > 1.0e-6 &&
+	(row == 0 || std::fabs(column[i]) > std::fabs(column[row]))) {
+      row = i;
+    }
+  }
+  if (row == 0)  return false;
+  p_tableau.Pivot(row, j);
+  return true;
+}
+
+//
+// Brings the columns of a random sparse matrix into the basis in
+// place of the slack columns, one at a time, checking the solves after
+// each change of basis, and after refactoring.  With p_refactor zero,
+// the basis is refactored when that is estimated to be cheaper than
+// continuing with the eta file; with it negative, never.
+//
+void TestPivots(int n, double p_density, int p_refactor)
+{
+  Matrix<double> A = RandomMatrix(n, p_density);
+  Vector<double> b = RandomVector(n);
+  Tableau<double> tableau(A, b);
+  tableau.SetRefactor(p_refactor);
+  CheckSolves(tableau, b);
+
+  for (int j = 1; j <= n; j++) {
+    if (!PivotIn(tableau, j))  continue;
+    CheckSolves(tableau, b);
+
+    // A copy shares the factorization of the original, and solves
+    // through it, in its own scratch space, after changes of its own
+    Tableau<double> copy(tableau);
+    CheckSolves(copy, b);
+    if (j < n && PivotIn(copy, j + 1)) {
+      CheckSolves(copy, b);
+    }
+  }
+
+  tableau.Refactor();
+  CheckSolves(tableau, b);
+}
+
+}  // end anonymous namespace
+
+int main(int, char **)
+{
+  std::srand(1);
+  int sizes[] = { 1, 4, 12, 40 };
+  double densities[] = { 0.1, 0.3, 1.0 };
+  int refactors[] = { 0, -1, 1 };
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 3; j++) {
+      for (int k = 0; k < 3; k++) {
+	TestPivots(sizes[i], densities[j], refactors[k]);
+      }
+    }
+  }
+  return TestResult();
+}
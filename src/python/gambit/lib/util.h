@@ -39,8 +39,7 @@ inline Game NewTable(Array<int> *dim)
 
 Game ReadGame(char *fn) throw (InvalidFileException)
 { 
-  std::ifstream f(fn);
-  return ReadGame(f);
+  return Gambit::ReadGame(std::string(fn));
 }
 
 Game ParseGame(char *s) throw (InvalidFileException)
@@ -22,7 +22,6 @@
 
 #include <iostream>
 #include <iomanip>
-#include <fstream>
 #include <cstdlib>
 #include <unistd.h>
 
@@ -49,6 +48,7 @@ void PrintHelp(char *progname)
   std::cerr << "  -O FORMAT        output file format (required):\n";
   std::cerr << "     FORMAT=html   convert to HTML\n";
   std::cerr << "     FORMAT=sgame  convert to LaTeX sgame style\n";
+  std::cerr << "     FORMAT=binary convert to binary format (strategic games)\n";
   std::cerr << "  -c PLAYER        the player to show on columns (default is 2)\n";
   std::cerr << "  -r PLAYER        the player to show on rows (default is 1)\n";
   std::cerr << "  -h               print this help message\n";
@@ -102,7 +102,7 @@ int main(int argc, char *argv[])
     std::cerr << argv[0] << ": Output format argument -O required.\n";
     return 1;
   }
-  else if (format != "sgame" && format != "html") {
+  else if (format != "sgame" && format != "html" && format != "binary") {
     std::cerr << argv[0] << ": Unknown output format '" << format << "'.\n";
     return 1;
   }
@@ -112,21 +112,20 @@ int main(int argc, char *argv[])
     return 1;
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) {
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
-    }
-    input_stream = &file_stream;
-  }
-
   try {
-    Gambit::Game game = Gambit::ReadGame(*input_stream);
+    // Files are read by name, which lets them be mapped into memory
+    Gambit::Game game = ((optind < argc) ?
+			  Gambit::ReadGame(std::string(argv[optind])) :
+			  Gambit::ReadGame(std::cin));
+
+    if (format == "binary") {
+      if (game->IsTree()) {
+	std::cerr << argv[0] << ": Binary format is only for strategic games.\n";
+	return 1;
+      }
+      game->Write(std::cout, "binary");
+      return 0;
+    }
 
     if (rowPlayer < 1 || rowPlayer > game->NumPlayers()) {
       std::cerr << argv[0] << ": Player " << rowPlayer << " does not exist.\n";
@@ -24,11 +24,13 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <iostream>
-#include <fstream>
 #include <cerrno>
 #include <iomanip>
+#include <vector>
+#include <map>
 
 #include "libgambit/libgambit.h"
+#include "libgambit/tasks.h"
 #include "clique.h"
 #include "vertenum.imp"
 
@@ -37,6 +39,7 @@ using namespace Gambit;
 
 bool g_showConnect = false;
 int g_numDecimals = 6;
+int g_numThreads = 1;
 
 bool EqZero(const double &x)
 {
@@ -76,26 +79,69 @@ void PrintProfile(std::ostream &p_stream,
   p_stream << std::endl;
 }
 
+//
+// The extreme equilibria found, as the edges of a bipartite graph on
+// the vertices of the two polytopes.  Vertices are numbered in the
+// order in which they first appear in an equilibrium, and each is keyed
+// by the corresponding strategy.
+//
+template <class T> class ExtremeEquilibria {
+public:
+  List<Vector<T> > m_key1, m_key2;
+  List<int> m_node1, m_node2;   // IDs of each component of the extreme equilibria
+  Array<int> m_vert1id;
+  // The vertices of the second polytope are not all known in advance
+  std::map<int, int> m_vert2id;
+  int m_numVerts2;
+
+  ExtremeEquilibria(int p_numVerts1)
+    : m_vert1id(p_numVerts1), m_numVerts2(0)
+  {
+    for (int i = 1; i <= m_vert1id.Length(); m_vert1id[i++] = 0);
+  }
+
+  void Add(int i1, int i2, const Game &p_game,
+	   const MixedStrategyProfile<T> &p_profile)
+  {
+    // note: The keys give the mixed strategy associated with each node. 
+    //       The keys should also keep track of the basis
+    //       As things stand now, two different bases could lead to
+    //       the same key... BAD!
+    if (m_vert1id[i1] == 0) {
+      m_vert1id[i1] = m_key2.Length() + 1;
+      m_key2.push_back(p_profile[p_game->GetPlayer(2)]);
+    }
+    if (m_vert2id.count(i2) == 0) {
+      m_vert2id[i2] = m_key1.Length() + 1;
+      m_key1.push_back(p_profile[p_game->GetPlayer(1)]);
+    }
+    m_node1.Append(m_vert2id[i2]);
+    m_node2.Append(m_vert1id[i1]);
+  }
+};
+
 template <class T> void GetCliques(std::ostream &p_stream,
 				   const Game &p_game,
-				   const List<int> &p_node1,
-				   const List<Vector<T> > &p_key1,
-				   int p_v1,
-				   const List<int> &p_node2,
-				   const List<Vector<T> > &p_key2,
-				   int p_v2)
+				   const ExtremeEquilibria<T> &p_equilibria)
 {
-  int n = p_node1.Length();
-  if (p_node2.Length() != n)  throw DimensionException();
+  const List<int> &node1 = p_equilibria.m_node1;
+  const List<int> &node2 = p_equilibria.m_node2;
+  const List<Vector<T> > &key1 = p_equilibria.m_key1;
+  const List<Vector<T> > &key2 = p_equilibria.m_key2;
+
+  int n = node1.Length();
+  if (node2.Length() != n)  throw DimensionException();
 
   Array<edge> edgelist(n);
 
-  for (int i = 1; i <= n; i++) {
-    edgelist[i].node1 = p_node1[i];
-    edgelist[i].node2 = p_node2[i];
+  List<int>::const_iterator n1 = node1.begin(), n2 = node2.begin();
+  for (int i = 1; i <= n; i++, ++n1, ++n2) {
+    edgelist[i].node1 = *n1;
+    edgelist[i].node2 = *n2;
   }
 
-  EnumCliques clique(edgelist, p_v2+1, p_v1+1);
+  EnumCliques clique(edgelist, p_equilibria.m_numVerts2 + 1,
+		     p_equilibria.m_vert1id.Length() + 1);
   const List<Array<int> > &cliques1 = clique.GetCliques1();
   const List<Array<int> > &cliques2 = clique.GetCliques2();
 
@@ -104,12 +150,12 @@ template <class T> void GetCliques(std::ostream &p_stream,
       for (int j = 1; j <= cliques2[cl].Length(); j++) {
 	MixedStrategyProfile<T> profile(p_game->NewMixedStrategyProfile(static_cast<T>(0)));
 
-	for (int k = 1; k <= p_key1[cliques1[cl][i]].Length(); k++) {
-	  profile[k] = p_key1[cliques1[cl][i]][k];
+	for (int k = 1; k <= key1[cliques1[cl][i]].Length(); k++) {
+	  profile[k] = key1[cliques1[cl][i]][k];
 	}
-	for (int k = 1; k <= p_key2[cliques2[cl][j]].Length(); k++) {
-	  profile[k + p_key1[cliques1[cl][i]].Length()] =
-	    p_key2[cliques2[cl][j]][k];
+	for (int k = 1; k <= key2[cliques2[cl][j]].Length(); k++) {
+	  profile[k + key1[cliques1[cl][i]].Length()] =
+	    key2[cliques2[cl][j]][k];
 	}
 	PrintProfile(p_stream, "convex-" + lexical_cast<std::string>(cl), 
 		     profile);
@@ -118,11 +164,240 @@ template <class T> void GetCliques(std::ostream &p_stream,
   }
 }
 
-template <class T> void Solve(const Game &p_game)
+//
+// Returns whether a vertex of the second polytope (a strategy of
+// player 1) and a vertex of the first (a strategy of player 2) are
+// complementary, and so form an equilibrium.  Both are feasible, so
+// only complementarity needs to be checked.
+//
+template <class T> bool IsComplementary(const BFS<T> &bfs1,
+					const BFS<T> &bfs2,
+					int n1, int n2)
+{
+  for (int k = 1; k <= n1; k++) {
+    if (bfs1.count(k) && bfs2.count(-k) && !EqZero(bfs1[k] * bfs2[-k])) {
+      return false;
+    }
+  }
+  for (int k = 1; k <= n2; k++) {
+    if (bfs2.count(k) && bfs1.count(-k) && !EqZero(bfs2[k] * bfs1[-k])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//
+// Whether a value is far enough from zero that its product with any
+// other such value is not taken to be zero by EqZero()
+//
+bool IsLarge(const double &x)
+{
+  return (x > 1.0e-7 || x < -1.0e-7);
+}
+
+bool IsLarge(const Rational &x)
 {
-  List<Vector<T> > key1, key2;  
-  List<int> node1, node2;   // IDs of each component of the extreme equilibria
+  return (x != Gambit::Rational(0));
+}
+
+//
+// Indexes the vertices of the first polytope by their labels, so the
+// vertices complementary to a vertex of the second polytope can be
+// found without testing every pair.  For each label, a bitset records
+// the vertices having it: label k is the k'th strategy of player 1
+// having zero slack, and label n1+k the k'th strategy of player 2
+// having zero probability.  A vertex of the second polytope requires
+// the labels of the strategies it uses and of the strategies of
+// player 2 with nonzero slack.  Values close to zero are treated as
+// labels, and the candidates found by intersecting the bitsets are
+// then confirmed by IsComplementary(), so the pairs found are exactly
+// those found by testing every pair.  The vertices are added as they
+// are enumerated.
+//
+template <class T> class VertexIndex : public VertexVisitor<T> {
+public:
+  VertexIndex(int p_n1, int p_n2)
+    : m_n1(p_n1), m_n2(p_n2), m_verts(1),
+      m_labels(p_n1 + p_n2, std::vector<Word>(1, 0))
+  { }
+  virtual ~VertexIndex() { }
+
+  /// Adds the next vertex of the first polytope
+  virtual void Visit(const BFS<T> &);
+
+  int NumVertices(void) const { return m_verts.size() - 1; }
+  const BFS<T> &GetVertex(int i) const { return m_verts[i]; }
+  /// Appends to p_partners the vertices complementary to p_vertex,
+  /// in increasing order
+  void GetPartners(const BFS<T> &p_vertex, std::vector<int> &p_partners) const;
+
+private:
+  typedef unsigned long Word;
+  enum { c_wordBits = 8 * sizeof(Word) };
+
+  int m_n1, m_n2;
+  std::vector<BFS<T> > m_verts;    // vertices are numbered from 1
+  std::vector<std::vector<Word> > m_labels;
+};
+
+template <class T> void VertexIndex<T>::Visit(const BFS<T> &p_vertex)
+{
+  int i = m_verts.size();
+  m_verts.push_back(p_vertex);
+  if (i % c_wordBits == 0) {
+    // Start the next word of each bitset
+    for (size_t label = 0; label < m_labels.size(); label++) {
+      m_labels[label].push_back(0);
+    }
+  }
+  if (i == 1) {
+    // The first vertex is the origin, which is in no equilibrium
+    return;
+  }
+  for (int k = 1; k <= m_n1; k++) {
+    if (!IsLarge(p_vertex[-k])) {
+      m_labels[k-1][i / c_wordBits] |= (Word) 1 << (i % c_wordBits);
+    }
+  }
+  for (int k = 1; k <= m_n2; k++) {
+    if (!IsLarge(p_vertex[k])) {
+      m_labels[m_n1+k-1][i / c_wordBits] |= (Word) 1 << (i % c_wordBits);
+    }
+  }
+}
 
+template <class T> void
+VertexIndex<T>::GetPartners(const BFS<T> &p_vertex,
+			    std::vector<int> &p_partners) const
+{
+  int numWords = (m_verts.size() - 1) / c_wordBits + 1;
+  std::vector<Word> candidates(numWords, ~(Word) 0);
+  candidates[0] &= ~(Word) 3;    // vertex 0 does not exist; 1 is the origin
+  for (int k = 1; k <= m_n1; k++) {
+    if (IsLarge(p_vertex[k])) {
+      for (int w = 0; w < numWords; w++) {
+	candidates[w] &= m_labels[k-1][w];
+      }
+    }
+  }
+  for (int k = 1; k <= m_n2; k++) {
+    if (IsLarge(p_vertex[-k])) {
+      for (int w = 0; w < numWords; w++) {
+	candidates[w] &= m_labels[m_n1+k-1][w];
+      }
+    }
+  }
+
+  for (int w = 0; w < numWords; w++) {
+    for (int bit = 0; candidates[w] != 0 && bit < c_wordBits; bit++) {
+      if (candidates[w] & ((Word) 1 << bit)) {
+	candidates[w] &= ~((Word) 1 << bit);
+	int i = w * c_wordBits + bit;
+	if (i < (int) m_verts.size() &&
+	    IsComplementary(p_vertex, m_verts[i], m_n1, m_n2)) {
+	  p_partners.push_back(i);
+	}
+      }
+    }
+  }
+}
+
+//
+// Finds the partners of a batch of vertices of the second polytope,
+// one vertex per task.
+//
+template <class T> class PairingTasks {
+public:
+  PairingTasks(const VertexIndex<T> &p_index,
+	       const std::vector<BFS<T> > &p_verts)
+    : m_index(p_index), m_verts(p_verts), m_partners(p_verts.size())
+  { }
+
+  void operator()(int p_task)
+  { m_index.GetPartners(m_verts[p_task], m_partners[p_task]); }
+
+  const std::vector<int> &GetPartners(int p_task) const
+  { return m_partners[p_task]; }
+
+private:
+  const VertexIndex<T> &m_index;
+  const std::vector<BFS<T> > &m_verts;
+  std::vector<std::vector<int> > m_partners;
+};
+
+//
+// Receives the vertices of the second polytope as they are enumerated,
+// and reports the equilibria they form with the vertices of the first.
+// The partners of the vertices are found in batches, by as many threads
+// as requested, and then reported in order.
+//
+template <class T> class VertexMatcher : public VertexVisitor<T> {
+public:
+  VertexMatcher(const Game &p_game, const VertexIndex<T> &p_index,
+		ExtremeEquilibria<T> &p_equilibria)
+    : m_game(p_game), m_index(p_index), m_equilibria(p_equilibria),
+      m_batchSize(64 * std::max(g_numThreads, 1))
+  { }
+  virtual ~VertexMatcher() { }
+
+  virtual void Visit(const BFS<T> &p_vertex)
+  {
+    // The first vertex is the origin, which is in no equilibrium
+    if (++m_equilibria.m_numVerts2 > 1) {
+      m_batch.push_back(p_vertex);
+      if ((int) m_batch.size() == m_batchSize) {
+	Flush();
+      }
+    }
+  }
+  /// Reports the equilibria formed by the vertices received so far
+  void Flush(void);
+
+private:
+  Game m_game;
+  const VertexIndex<T> &m_index;
+  ExtremeEquilibria<T> &m_equilibria;
+  int m_batchSize;
+  std::vector<BFS<T> > m_batch;
+};
+
+template <class T> void VertexMatcher<T>::Flush(void)
+{
+  PairingTasks<T> tasks(m_index, m_batch);
+  RunTasks(tasks, m_batch.size(), g_numThreads);
+
+  int n1 = m_game->Players()[1]->Strategies().size();
+  int n2 = m_game->Players()[2]->Strategies().size();
+  int first = m_equilibria.m_numVerts2 - m_batch.size() + 1;
+  for (size_t v = 0; v < m_batch.size(); v++) {
+    const BFS<T> &bfs1 = m_batch[v];
+    const std::vector<int> &partners = tasks.GetPartners(v);
+    for (size_t p = 0; p < partners.size(); p++) {
+      const BFS<T> &bfs2 = m_index.GetVertex(partners[p]);
+
+      MixedStrategyProfile<T> profile(m_game->NewMixedStrategyProfile(static_cast<T>(0)));
+      static_cast<Vector<T> &>(profile) = static_cast<T>(0);
+      for (int k = 1; k <= n1; k++) {
+	if (bfs1.count(k)) {
+	  profile[m_game->Players()[1]->Strategies()[k]] = -bfs1[k];
+	}
+      } 
+      for (int k = 1; k <= n2; k++) {
+	if (bfs2.count(k)) {
+	  profile[m_game->Players()[2]->Strategies()[k]] = -bfs2[k];
+	}
+      } 
+      profile.Normalize();
+      PrintProfile(std::cout, "NE", profile);
+      m_equilibria.Add(partners[p], first + v, m_game, profile);
+    }
+  }
+  m_batch.clear();
+}
+
+template <class T> void Solve(const Game &p_game)
+{
   PureStrategyProfile profile = p_game->NewPureStrategyProfile();
 
   Rational min = p_game->GetMinPayoff();
@@ -138,15 +413,16 @@ template <class T> void Solve(const Game &p_game)
 
   Rational fac(1, max - min);
 
+  int n1 = p_game->Players()[1]->Strategies().size();
+  int n2 = p_game->Players()[2]->Strategies().size();
+
   // Construct matrices A1, A2
-  Matrix<T> A1(1, p_game->Players()[1]->Strategies().size(),
-	       1, p_game->Players()[2]->Strategies().size());
-  Matrix<T> A2(1, p_game->Players()[2]->Strategies().size(),
-	       1, p_game->Players()[1]->Strategies().size());
+  Matrix<T> A1(1, n1, 1, n2);
+  Matrix<T> A2(1, n2, 1, n1);
 
-  for (int i = 1; i <= p_game->Players()[1]->Strategies().size(); i++) {
+  for (int i = 1; i <= n1; i++) {
     profile->SetStrategy(p_game->Players()[1]->Strategies()[i]);
-    for (int j = 1; j <= p_game->Players()[2]->Strategies().size(); j++) {
+    for (int j = 1; j <= n2; j++) {
       profile->SetStrategy(p_game->Players()[2]->Strategies()[j]);
       A1(i, j) = fac * (profile->GetPayoff(1) - min);
       A2(j, i) = fac * (profile->GetPayoff(2) - min);
@@ -154,86 +430,23 @@ template <class T> void Solve(const Game &p_game)
   }
 
   // Construct vectors b1, b2
-  Vector<T> b1(1, p_game->Players()[1]->Strategies().size());
-  Vector<T> b2(1, p_game->Players()[2]->Strategies().size());
+  Vector<T> b1(1, n1);
+  Vector<T> b2(1, n2);
   b1 = (T) -1;
   b2 = (T) -1;
 
-  // enumerate vertices of A1 x + b1 <= 0 and A2 x + b2 <= 0
-  VertEnum<T> poly1(A1, b1);
-  VertEnum<T> poly2(A2, b2);
-
-  const List<BFS<T> > &verts1(poly1.VertexList());
-  const List<BFS<T> > &verts2(poly2.VertexList());
-  int v1 = verts1.Length();
-  int v2 = verts2.Length();
-
-  Array<int> vert1id(v1);
-  Array<int> vert2id(v2);
-  for (int i = 1; i <= vert1id.Length(); vert1id[i++] = 0);
-  for (int i = 1; i <= vert2id.Length(); vert2id[i++] = 0);
-
-  int i = 0;
-  int id1 = 0, id2 = 0;
-
-  for (int i2 = 2; i2 <= v2; i2++) {
-    BFS<T> bfs1 = verts2[i2];
-    i++;
-    for (int i1 = 2; i1 <= v1; i1++) {
-      BFS<T> bfs2 = verts1[i1];
-	
-      // check if solution is nash 
-      // need only check complementarity, since it is feasible
-      bool nash = true;
-      for (int k = 1; nash && k <= p_game->Players()[1]->Strategies().size(); k++) {
-	if (bfs1.count(k) && bfs2.count(-k)) {
-	  nash = nash && EqZero(bfs1[k] * bfs2[-k]);
-	}
-      }
-
-      for (int k = 1; nash && k <= p_game->Players()[2]->Strategies().size(); k++) {
-	if (bfs2.count(k) && bfs1.count(-k)) {
-	  nash = nash && EqZero(bfs2[k] * bfs1[-k]);
-	}
-      }
+  // enumerate vertices of A1 x + b1 <= 0 and A2 x + b2 <= 0.
+  // Those of the second are matched to those of the first as they
+  // are found, so equilibria are reported as soon as they are known.
+  VertexIndex<T> index(n1, n2);
+  VertEnum<T> poly1(A1, b1, index);
+  ExtremeEquilibria<T> equilibria(index.NumVertices());
+  VertexMatcher<T> matcher(p_game, index, equilibria);
+  VertEnum<T> poly2(A2, b2, matcher);
+  matcher.Flush();
 
-      if (nash) {
-	MixedStrategyProfile<T> profile(p_game->NewMixedStrategyProfile(static_cast<T>(0)));
-	static_cast<Vector<T> &>(profile) = static_cast<T>(0);
-	for (int k = 1; k <= p_game->Players()[1]->Strategies().size(); k++) {
-	  if (bfs1.count(k)) {
-	    profile[p_game->Players()[1]->Strategies()[k]] = -bfs1[k];
-	  }
-	} 
-	for (int k = 1; k <= p_game->Players()[2]->Strategies().size(); k++) {
-	  if (bfs2.count(k)) {
-	    profile[p_game->Players()[2]->Strategies()[k]] = -bfs2[k];
-	  }
-	} 
-	profile.Normalize();
-	PrintProfile(std::cout, "NE", profile);
-	  
-	// note: The keys give the mixed strategy associated with each node. 
-	//       The keys should also keep track of the basis
-	//       As things stand now, two different bases could lead to
-	//       the same key... BAD!
-	if (vert1id[i1] == 0) {
-	  id1++;
-	  vert1id[i1] = id1;
-	  key2.push_back(profile[p_game->GetPlayer(2)]);
-	}
-	if (vert2id[i2] == 0) {
-	  id2++;
-	  vert2id[i2] = id2;
-	  key1.push_back(profile[p_game->GetPlayer(1)]);
-	}
-	node1.Append(vert2id[i2]);
-	node2.Append(vert1id[i1]);
-      }
-    }
-  }
   if (g_showConnect) {
-    GetCliques(std::cout, p_game, node1, key1, v1, node2, key2, v2);
+    GetCliques(std::cout, p_game, equilibria);
   }
 }
 
@@ -261,6 +474,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -D               don't eliminate dominated strategies first\n";
   std::cerr << "  -L               use lrslib for enumeration (experimental!)\n";
   std::cerr << "  -c               output connectedness information\n";
+  std::cerr << "  -j THREADS       match vertices of the polytopes using\n";
+  std::cerr << "                   THREADS worker threads\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -278,7 +493,7 @@ int main(int argc, char *argv[])
     { "version", 0, NULL, 'v'  },
     { 0,    0,    0,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqcS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DvhqcSj:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -298,6 +513,9 @@ int main(int argc, char *argv[])
     case 'c':
       g_showConnect = true;
       break;
+    case 'j':
+      g_numThreads = atoi(optarg);
+      break;
     case 'S':
       break;
     case 'q':
@@ -320,21 +538,11 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) {
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
-    }
-    input_stream = &file_stream;
-  }
-
   try {
-    Game game = ReadGame(*input_stream);
+    // Files are read by name, which lets them be mapped into memory
+    Game game = ((optind < argc) ?
+		  ReadGame(std::string(argv[optind])) :
+		  ReadGame(std::cin));
     if (game->NumPlayers() != 2) {
       std::cerr << "Error: Game does not have two players.\n";
       return 1;
@@ -27,6 +27,16 @@
 #include "liblinear/lptab.h"
 #include "liblinear/bfs.h"
 
+//
+// Receives the vertices of a polyhedron from VertEnum one at a time,
+// as they are found
+//
+template <class T> class VertexVisitor {
+public:
+  virtual ~VertexVisitor() { }
+  virtual void Visit(const BFS<T> &) = 0;
+};
+
 
 //
 // This class enumerates the vertices of the convex polyhedron 
@@ -35,7 +45,9 @@
 // 
 // where b <= 0.  Enumeration starts from the vertex y = 0.
 // All computation is done in the class constructor. The 
-// list of vertices can be accessed by VertexList()
+// list of vertices can be accessed by VertexList(), unless a
+// VertexVisitor is given, in which case each vertex is passed to it
+// as it is found, and none are stored.
 //  
 // The code is based on the reverse Pivoting algorithm of Avis 
 // and Fukuda, Discrete Computational Geom (1992) 8:295-313.
@@ -55,6 +67,7 @@ private:
   Gambit::List<Gambit::Vector<T> > Verts;
   long npivots,nodes;
   Gambit::List<long> visits,branches;
+  VertexVisitor<T> *visitor;
 
   void Enum();
   void Deeper();
@@ -63,6 +76,8 @@ private:
   void DualSearch(LPTableau<T> &tab);
 public:
   VertEnum(const Gambit::Matrix<T> &, const Gambit::Vector<T> &);
+  VertEnum(const Gambit::Matrix<T> &, const Gambit::Vector<T> &,
+	   VertexVisitor<T> &);
   VertEnum(LPTableau<T> &);
   virtual ~VertEnum();
 
@@ -24,7 +24,6 @@
 #include <getopt.h>
 #include <unistd.h>
 #include <iostream>
-#include <fstream>
 #include <cerrno>
 #include "enumpure.h"
 
@@ -47,6 +46,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -S               report equilibria in strategies even for extensive games\n";
   std::cerr << "  -A               compute agent form equilibria\n";
   std::cerr << "  -P               find only subgame-perfect equilibria\n";
+  std::cerr << "  -j THREADS       check contingencies of strategic games using\n";
+  std::cerr << "                   THREADS worker threads\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -59,6 +60,7 @@ int main(int argc, char *argv[])
   opterr = 0;
   bool quiet = false, reportStrategic = false, solveAgent = false, bySubgames = false;
   bool printDetail = false;
+  int numThreads = 0;
   
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -67,7 +69,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "DvhqASP", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "DvhqASPj:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -83,6 +85,9 @@ int main(int argc, char *argv[])
     case 'P':
       bySubgames = true;
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
     case 'h':
       PrintHelp(argv[0]);
       break;
@@ -106,21 +111,11 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) {
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
-    }
-    input_stream = &file_stream;
-  }
-
   try {
-    Game game = ReadGame(*input_stream);
+    // Files are read by name, which lets them be mapped into memory
+    Game game = ((optind < argc) ?
+		  ReadGame(std::string(argv[optind])) :
+		  ReadGame(std::cin));
     shared_ptr<StrategyProfileRenderer<Rational> > renderer;
     if (reportStrategic || !game->IsTree()) {
       if (printDetail) {
@@ -164,7 +159,13 @@ int main(int argc, char *argv[])
 	}
       }
     }
+    else if (numThreads > 0) {
+      NashEnumPureStrategyParallelSolver algorithm(numThreads, renderer);
+      algorithm.Solve(game);
+    }
     else {
+      // Check each contingency against tabulated best-response payoffs
+      game->SetCompiledPayoffs(true);
       NashEnumPureStrategySolver algorithm(renderer);
       algorithm.Solve(game);
     }
@@ -54,6 +54,31 @@ NashEnumPureStrategySolver::Solve(const Game &p_game) const
   return solutions;
 }
 
+/// \brief Enumerates pure-strategy equilibria of a table game in parallel
+///
+/// Rather than evaluating every unilateral deviation from each contingency,
+/// this first tabulates, for each player and each profile of strategies of
+/// the other players, the best payoff the player can obtain, as a double.
+/// The contingencies are then divided into blocks, which are checked
+/// against these tables in batches by worker threads; exact payoffs are
+/// compared only where rounding leaves the order in doubt.  Equilibria
+/// are reported in the same order as by NashEnumPureStrategySolver.
+///
+/// Games which are not in table form are solved serially by
+/// NashEnumPureStrategySolver.
+class NashEnumPureStrategyParallelSolver : public NashStrategySolver<Rational> {
+public:
+  NashEnumPureStrategyParallelSolver(int p_numThreads,
+				     Gambit::shared_ptr<StrategyProfileRenderer<Rational> > p_onEquilibrium = 0) 
+    : NashStrategySolver<Rational>(p_onEquilibrium), 
+      m_numThreads(p_numThreads) { }
+  virtual ~NashEnumPureStrategyParallelSolver()  { }
+
+  List<MixedStrategyProfile<Rational> > Solve(const Game &p_game) const;
+
+private:
+  int m_numThreads;
+};
 
 class NashEnumPureAgentSolver : public NashBehavSolver<Rational> {
 public:
@@ -0,0 +1,175 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/enumpure/nfgenumpure.cc
+// Parallel enumeration of pure-strategy equilibria in strategic games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <vector>
+#include <algorithm>
+
+#include "libgambit/libgambit.h"
+#include "libgambit/gametable.h"
+#include "libgambit/tasks.h"
+#include "enumpure.h"
+
+namespace {
+
+/// Number of contingencies checked by a task
+const long c_blockSize = 65536L;
+
+//------------------------------------------------------------------------
+//                       class EnumPureTables
+//------------------------------------------------------------------------
+
+//
+// The tables used to check contingencies: the compiled table of each
+// player's payoffs as doubles, and the game's table of the best payoff
+// each player can obtain against each profile of strategies of the
+// others.  Exact payoffs are read from the game only to settle
+// near-ties.  The tables are fetched when this object is created, so
+// the worker threads only read from arrays and from the game's
+// outcomes; in particular, they never touch the (reference-counted)
+// game objects.
+//
+class EnumPureTables {
+public:
+  EnumPureTables(const Game &p_game);
+
+  /// The number of contingencies in the game
+  long NumContingencies(void) const { return m_game.NumContingencies(); }
+
+  /// Append to p_equilibria the indices of equilibria among
+  /// contingencies p_first through p_last-1
+  void FindEquilibria(long p_first, long p_last,
+		      std::vector<long> &p_equilibria) const;
+
+private:
+  const GameTableRep &m_game;
+  int m_numPlayers;
+  /// The payoffs to each player, indexed by contingency
+  std::vector<const double *> m_payoffs;
+  /// The best payoff to each player, indexed by opponent profile as
+  /// in GameTableRep::GetBestPayoffTable()
+  std::vector<const double *> m_bestPayoffs;
+};
+
+EnumPureTables::EnumPureTables(const Game &p_game)
+  : m_game(dynamic_cast<const GameTableRep &>(*p_game)),
+    m_numPlayers(p_game->NumPlayers()),
+    m_payoffs(m_numPlayers), m_bestPayoffs(m_numPlayers)
+{
+  for (int pl = 0; pl < m_numPlayers; pl++) {
+    m_payoffs[pl] = m_game.GetPayoffTable(pl+1, 0.0);
+    m_bestPayoffs[pl] = m_game.GetBestPayoffTable(pl+1);
+  }
+}
+
+void EnumPureTables::FindEquilibria(long p_first, long p_last,
+				    std::vector<long> &p_equilibria) const
+{
+  for (long index = p_first; index < p_last; index++) {
+    int pl = 0;
+    while (pl < m_numPlayers &&
+	   m_game.IsBestPayoff(pl+1, index, m_payoffs[pl], m_bestPayoffs[pl])) {
+      pl++;
+    }
+    if (pl == m_numPlayers) {
+      p_equilibria.push_back(index);
+    }
+  }
+}
+
+//------------------------------------------------------------------------
+//                        class EnumPureTasks
+//------------------------------------------------------------------------
+
+//
+// Checks a batch of consecutive blocks of contingencies, one block per
+// task, holding the equilibria found in each block until they are
+// reported in order.
+//
+class EnumPureTasks {
+public:
+  EnumPureTasks(const EnumPureTables &p_tables, long p_firstBlock,
+		int p_numBlocks)
+    : m_tables(p_tables), m_firstBlock(p_firstBlock),
+      m_equilibria(p_numBlocks)
+  { }
+
+  void operator()(int p_task)
+  {
+    long first = (m_firstBlock + p_task) * c_blockSize;
+    long last = std::min(first + c_blockSize, m_tables.NumContingencies());
+    m_tables.FindEquilibria(first, last, m_equilibria[p_task]);
+  }
+
+  /// The indices of the equilibria found in the block of the task
+  const std::vector<long> &GetEquilibria(int p_task) const
+  { return m_equilibria[p_task]; }
+
+private:
+  const EnumPureTables &m_tables;
+  long m_firstBlock;
+  std::vector<std::vector<long> > m_equilibria;
+};
+
+}  // end anonymous namespace
+
+//------------------------------------------------------------------------
+//              class NashEnumPureStrategyParallelSolver
+//------------------------------------------------------------------------
+
+List<MixedStrategyProfile<Rational> >
+NashEnumPureStrategyParallelSolver::Solve(const Game &p_game) const
+{
+  if (p_game->IsTree()) {
+    return NashEnumPureStrategySolver(m_onEquilibrium).Solve(p_game);
+  }
+
+  EnumPureTables tables(p_game);
+  long numBlocks = (tables.NumContingencies() + c_blockSize - 1) / c_blockSize;
+  // A few blocks per thread in each batch keeps the threads busy while
+  // blocks vary in the time they take
+  long batchSize = 4 * std::max(m_numThreads, 1);
+
+  List<MixedStrategyProfile<Rational> > solutions;
+  for (long firstBlock = 0; firstBlock < numBlocks; firstBlock += batchSize) {
+    int numTasks = (int) std::min(batchSize, numBlocks - firstBlock);
+    EnumPureTasks tasks(tables, firstBlock, numTasks);
+    RunTasks(tasks, numTasks, m_numThreads);
+
+    for (int task = 0; task < numTasks; task++) {
+      const std::vector<long> &equilibria = tasks.GetEquilibria(task);
+      for (size_t i = 0; i < equilibria.size(); i++) {
+	PureStrategyProfile pure = p_game->NewPureStrategyProfile();
+	long stride = 1L;
+	for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+	  GamePlayer player = p_game->GetPlayer(pl);
+	  pure->SetStrategy(player->GetStrategy((equilibria[i] / stride) %
+						player->NumStrategies() + 1));
+	  stride *= player->NumStrategies();
+	}
+	MixedStrategyProfile<Rational> profile = pure->ToMixedStrategyProfile();
+	m_onEquilibrium->Render(profile);
+	solutions.Append(profile);
+      }
+    }
+  }
+  return solutions;
+}
@@ -31,21 +31,21 @@ void aggame:: computePartialP_PureNode(int player1,int act1, vector<int>& tasks)
     vector<AggNumber> strat (numNei);
     agg::config    a(numNei,0);
     //compute the full distrib
-    aggPtr->computeP (player1,act1);
+    aggPtr->computeP (workspace, player1,act1);
 
     //store the full distrib in Pr[player1]
-    aggPtr->Pr[player1].swap(aggPtr->Pr[numPlayers-1]);
+    workspace.Pr[player1].swap(workspace.Pr[numPlayers-1]);
     for(i=0;i<(int)tasks.size();i++){
       //assert(tasks[i]!=player1);
-      aggdistrib& P = aggPtr->Pr[tasks[i]];
+      aggdistrib& P = workspace.Pr[tasks[i]];
       //P.clear();  // to get ready for division, we need clear()
-      P=aggPtr->Pr[player1];
+      P=workspace.Pr[player1];
 
       bool NullOnly =true;
       for(j=0;j<numNei;++j){
 	a[j]++;
-	aggdistrib::iterator pp = aggPtr->projectedStrat[Node][tasks[i]].find(a);
-	if (pp== aggPtr->projectedStrat[Node][tasks[i]].end()) {
+	aggdistrib::iterator pp = workspace.projectedStrat[Node][tasks[i]].find(a);
+	if (pp== workspace.projectedStrat[Node][tasks[i]].end()) {
 	    strat[j]=0;
 	}
 	else {
@@ -87,7 +87,7 @@ void aggame::computePartialP_bisect(int player1,int act1,
     <<", act1="<<act1<<" *start="<<*start<<" *(endp-1)="<<*(endp-1)
     <<", (endp-start)="<< endp-start <<endl;
 #endif
-  if(endp-start==1){aggPtr->Pr[*start].reset();return;}
+  if(endp-start==1){workspace.Pr[*start].reset();return;}
   int Node = aggPtr->actionSets[player1][act1];
   int numNei=aggPtr->neighbors[Node].size();
 
@@ -102,27 +102,29 @@ void aggame::computePartialP_bisect(int player1,int act1,
 
 
   temp.reset();
-  temp = aggPtr->projectedStrat[Node][*start];
-  if (mid-start>1) temp.multiply(aggPtr->Pr[*start],numNei,aggPtr->projFunctions[Node]);
+  temp.setLayout(aggPtr->keyLayouts[Node]);
+  temp = workspace.projectedStrat[Node][*start];
+  if (mid-start>1) temp.multiply(workspace.Pr[*start],numNei,aggPtr->projFunctions[Node]);
 
   if (mid-start==1) {
-    //assert(aggPtr->Pr[*start].empty());
-    aggPtr->Pr[*start]= aggPtr->projectedStrat[Node][*mid];
-    if(endp-mid>1) aggPtr->Pr[*start].multiply(aggPtr->Pr[*mid],numNei,aggPtr->projFunctions[Node]);
+    //assert(workspace.Pr[*start].empty());
+    workspace.Pr[*start].setLayout(aggPtr->keyLayouts[Node]);
+    workspace.Pr[*start]= workspace.projectedStrat[Node][*mid];
+    if(endp-mid>1) workspace.Pr[*start].multiply(workspace.Pr[*mid],numNei,aggPtr->projFunctions[Node]);
   }
   else for (ptr=start; ptr!=mid; ++ptr){
     player2= *ptr;
-    aggPtr->Pr[player2].multiply(aggPtr->projectedStrat[Node][*mid],numNei,aggPtr->projFunctions[Node] );
-    if(endp-mid>1) aggPtr->Pr[player2].multiply(aggPtr->Pr[*mid],numNei,aggPtr->projFunctions[Node]);
+    workspace.Pr[player2].multiply(workspace.projectedStrat[Node][*mid],numNei,aggPtr->projFunctions[Node] );
+    if(endp-mid>1) workspace.Pr[player2].multiply(workspace.Pr[*mid],numNei,aggPtr->projFunctions[Node]);
   }
 
   if(endp-mid==1){
-    //assert(aggPtr->Pr[*mid].empty());
-    aggPtr->Pr[*mid]=temp;
+    //assert(workspace.Pr[*mid].empty());
+    workspace.Pr[*mid]=temp;
   }
   else for (ptr=mid;ptr!=endp;++ptr){
     player2=*ptr;
-    aggPtr->Pr[player2].multiply(temp,numNei, aggPtr->projFunctions[Node]);
+    workspace.Pr[player2].multiply(temp,numNei, aggPtr->projFunctions[Node]);
 
   }
 
@@ -141,16 +143,16 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 #endif
   AggNumber fuzzcount;
   int rown, coln, rowi, coli,act1,act2,currNode,numNei;
-  static vector<int>::iterator p;
-  static vector<int> tasks,spares,nontasks;
+  vector<int>::iterator p;
+  vector<int> tasks,spares,nontasks;
   tasks.reserve(aggPtr->numPlayers);
   spares.reserve(aggPtr->numPlayers);
   nontasks.reserve(aggPtr->numPlayers);
-  aggPtr->cache.reset();
+  workspace.cache.reset();
 
   //do projection
   for(int Node=0; Node< aggPtr->numActionNodes; Node++)
-	aggPtr->doProjection(Node,s.values());
+	aggPtr->doProjection(workspace, Node,s.values());
 
   //deal with the diagonal
   for (rown=0; rown<aggPtr->numPlayers; ++rown){
@@ -170,7 +172,7 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 #ifdef AGGDEBUG
             cout<<"for player "<<rown<<", action "<<act1
                 <<", action node "<<currNode<<endl;
-	    cout<< "cache is: "<<endl<<aggPtr->cache<<endl;
+	    cout<< "cache is: "<<endl<<workspace.cache<<endl;
 #endif
 	    tasks.clear();  //for these col players, we need to compute the distribution induced by their complements. input of the bisection alg
 	    spares.clear(); //these col players have only one projected action
@@ -194,8 +196,8 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
                 copy(key.begin(),key.end(),ostream_iterator<int>(cout," ") );
                 cout<<"]\n";
 #endif
-	        aggdistrib::iterator r= aggPtr->cache.findExact(key);
-	        if (r!=aggPtr->cache.end()){
+	        aggdistrib::iterator r= workspace.cache.findExact(key);
+	        if (r!=workspace.cache.end()){
 	          dest[act1+firstAction(rown)][act2+firstAction(coln)]=r->second;
 	        }
 	        else{
@@ -229,33 +231,34 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 	    if(aggPtr->isPure[currNode]||tasks.size()==0){
 	      computePartialP_PureNode(rown, act1,tasks);
 	    }else{//do bisection
-	      computePartialP_bisect(rown,act1,tasks.begin(),tasks.end(),aggPtr->Pr[rown]);
+	      computePartialP_bisect(rown,act1,tasks.begin(),tasks.end(),workspace.Pr[rown]);
 #ifdef AGGDEBUG
               cout<<"after calling computePartialP_bisect:"<<endl;
               for (int tt=0;tt<tasks.size();tt++){
                 cout<<"for player "<<tasks[tt]<<endl;
-                cout<<aggPtr->Pr[tasks[tt]]<<endl;
+                cout<<workspace.Pr[tasks[tt]]<<endl;
               }
 #endif
 	      //now apply rown's action (act1), and the strategies of
 	      //players in nontasks
-          aggPtr->Pr[rown].reset();
-          aggPtr->Pr[rown].insert(
+          workspace.Pr[rown].reset();
+          workspace.Pr[rown].setLayout(aggPtr->keyLayouts[currNode]);
+          workspace.Pr[rown].insert(
 		    make_pair(aggPtr->projection[currNode][rown][act1],1.0));
 	      for(p=nontasks.begin();p!=nontasks.end();++p)
-	    	  aggPtr->Pr[rown].multiply(aggPtr->projectedStrat[currNode][*p],numNei, aggPtr->projFunctions[currNode]);
+	    	  workspace.Pr[rown].multiply(workspace.projectedStrat[currNode][*p],numNei, aggPtr->projFunctions[currNode]);
 #ifdef AGGDEBUG
               cout<<"the polynomial product of strats of player "
                   <<rown<< " and players in the vector nontasks is:"
                   <<endl;
-              cout<<aggPtr->Pr[rown]<<endl;
+              cout<<workspace.Pr[rown]<<endl;
 #endif
 	      if (tasks.size()==1){
-	    	  aggPtr->Pr[tasks[0]]=aggPtr->Pr[rown];
+	    	  workspace.Pr[tasks[0]]=workspace.Pr[rown];
 	      }
 	      else {
                 for(p=tasks.begin();p!=tasks.end();++p){
-		  if(aggPtr->Pr[*p].size()==0){
+		  if(workspace.Pr[*p].size()==0){
 		    cerr<<"AGG::payoffMatrix() ERROR for rown="
 		        <<rown<<" act1="<<act1<<" *p=" <<*p
 		        <<": the distribution should not be empty!"<<endl;
@@ -264,8 +267,8 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 #endif
 
 		  }
-		  aggPtr->Pr[*p].multiply(
-				  aggPtr->Pr[rown],numNei,aggPtr->projFunctions[currNode]);
+		  workspace.Pr[*p].multiply(
+				  workspace.Pr[rown],numNei,aggPtr->projFunctions[currNode]);
 	        }//end for(p=tasks.begin...
 	      }
 
@@ -274,10 +277,10 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 	      //we store this distrib in Pr[rown][act1][rown]
 	      if (spares.size()>0){
 		//assert(tasks.size()>0);
-	    	  aggPtr->Pr[rown].reset();
-	    	  aggPtr->Pr[rown].multiply(
-	    			  aggPtr->Pr[tasks[0]],
-	    			  aggPtr->projectedStrat[currNode][tasks[0]],numNei,aggPtr->projFunctions[currNode]);
+	    	  workspace.Pr[rown].reset();
+	    	  workspace.Pr[rown].multiply(
+	    			  workspace.Pr[tasks[0]],
+	    			  workspace.projectedStrat[currNode][tasks[0]],numNei,aggPtr->projFunctions[currNode]);
 	      }
 	    } //end else
 #ifdef AGGDEBUG
@@ -285,7 +288,7 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
                 <<endl;
             for (int tt = 0;tt<numPlayers;tt++){
               cout<<"for player "<<tt<<endl;
-              cout<<aggPtr->Pr[tt];
+              cout<<workspace.Pr[tt];
               cout<<endl;
             }
 #endif
@@ -297,19 +300,19 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 	      computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1, rown);
 	      for(p=spares.begin();p!=spares.end();++p)
 		for(act2=0;act2<aggPtr->actions[*p];act2++)
-		  savePayoff(dest,rown,act1,*p,act2, undisturbedPayoff,aggPtr->cache);
+		  savePayoff(dest,rown,act1,*p,act2, undisturbedPayoff,workspace.cache);
 
 	    }
 	    for(p=tasks.begin();p!=tasks.end();++p){
 	      for(act2=0;act2<aggPtr->actions[*p];act2++){//act2: col action
 
-		if (aggPtr->projectedStrat[currNode][*p].size()==1  &&
-				aggPtr->projectedStrat[currNode][*p].begin()->first==aggPtr->projection[currNode][*p][act2])
+		if (workspace.projectedStrat[currNode][*p].size()==1  &&
+				workspace.projectedStrat[currNode][*p].begin()->first==aggPtr->projection[currNode][*p][act2])
 		{
 		  computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1,*p);
-		  savePayoff(dest,rown,act1,*p,act2,undisturbedPayoff,aggPtr->cache);
+		  savePayoff(dest,rown,act1,*p,act2,undisturbedPayoff,workspace.cache);
 		}
-		computePayoff(dest,rown,act1,*p,act2,aggPtr->cache);
+		computePayoff(dest,rown,act1,*p,act2,workspace.cache);
 	      }//end for(act2
 	    }//end for(p
 	}//end for(act1
@@ -323,11 +326,11 @@ void aggame::computeUndisturbedPayoff(AggNumber& undisturbedPayoff,bool& has,int
   int    Node =aggPtr->actionSets[player1][act1];
   int    numNei= aggPtr->neighbors[Node].size();
   if (player2==player1){
-    undisturbedPayoff=aggPtr->Pr[player2].inner_prod(aggPtr->payoffs[Node]);
+    undisturbedPayoff=workspace.Pr[player2].inner_prod(aggPtr->payoffs[Node]);
   }else{
-    //assert(aggPtr->projectedStrat[Node][player2].size()==1);
-    undisturbedPayoff=aggPtr->Pr[player2].inner_prod(
-    		aggPtr->projectedStrat[Node][player2].begin()->first,numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
+    //assert(workspace.projectedStrat[Node][player2].size()==1);
+    undisturbedPayoff=workspace.Pr[player2].inner_prod(
+    		workspace.projectedStrat[Node][player2].begin()->first,numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
   }
   has=true;
 }
@@ -372,7 +375,7 @@ void aggame::computePayoff(cmatrix& dest,int player1,int act1,int player2,int ac
   if (! r.second) {
     dest[act1+firstAction(player1)][act2+firstAction(player2)]=r.first->second;
   }else{
-    r.first->second=aggPtr->Pr[player2].inner_prod(
+    r.first->second=workspace.Pr[player2].inner_prod(
     		aggPtr->projection[Node][player2][act2],numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
     savePayoff(dest,player1,act1,player2,act2,r.first->second,cache,r.second);
   }
@@ -387,7 +390,7 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
   }
   //assert(getNumPlayers()>1);
 
-  aggPtr->cache.clear();
+  workspace.cache.clear();
 
   AggNumber fuzzcount;
 
@@ -397,10 +400,10 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
     numNei= aggPtr->neighbors[currNode].size();
     //vector<int> key (numNei+1);
     //key[numNei]=currNode;
-    aggPtr->doProjection(currNode,0,&(s[firstAction(0)]));
-    aggdistrib &Pdest = aggPtr->Pr[numPlayers-1];
-    aggPtr->projectedStrat[currNode][0].power(numPlayers-2, Pdest, aggPtr->Pr[numPlayers-2],numNei,aggPtr->projFunctions[currNode]);
-    aggdistrib &temp=aggPtr->Pr[numPlayers-2];
+    aggPtr->doProjection(workspace, currNode,0,&(s[firstAction(0)]));
+    aggdistrib &Pdest = workspace.Pr[numPlayers-1];
+    workspace.projectedStrat[currNode][0].power(numPlayers-2, Pdest, workspace.Pr[numPlayers-2],numNei,aggPtr->projFunctions[currNode]);
+    aggdistrib &temp=workspace.Pr[numPlayers-2];
     temp.reset();
     temp.insert(make_pair(aggPtr->projection[currNode][0][rowa],1));
     Pdest.multiply(temp,numNei,aggPtr->projFunctions[currNode]);
@@ -409,7 +412,7 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 
       //insPair.first.reserve(numNei+3);
       insPair.first.push_back(currNode);
-      pair<trie_map<AggNumber>::iterator,bool> r =aggPtr->cache.insert(insPair);
+      pair<trie_map<AggNumber>::iterator,bool> r =workspace.cache.insert(insPair);
 
       if (! r.second) {
           dest[rowa][cola]=r.first->second;
@@ -447,7 +450,7 @@ void aggame::KSymPayoffMatrix(cmatrix &dest, cvector &s, AggNumber fuzz){
 
           dest[rowa+firstKSymAction(rowcls)][cola+firstKSymAction(colcls)]=
               (AggNumber)multiplier *
-              aggPtr->getKSymMixedPayoff(sp,rowcls,rowa,colcls,cola);
+              aggPtr->getKSymMixedPayoff(workspace, sp,rowcls,rowa,colcls,cola);
         }
       }
     }
@@ -45,13 +45,13 @@ class aggame : public gnmgame {
 
     aggame ( agg* _aggPtr)
       :gnmgame(_aggPtr->getNumPlayers(), _aggPtr->actions),
-      aggPtr (_aggPtr)
+      aggPtr (_aggPtr), workspace(*_aggPtr)
     {
     }
 
     aggame(Gambit::GameAggRep& g)
       :gnmgame(g.aggPtr->getNumPlayers(), g.aggPtr->actions),
-      aggPtr (g.aggPtr)
+      aggPtr (g.aggPtr), workspace(*g.aggPtr)
     {
     }
 
@@ -64,12 +64,12 @@ class aggame : public gnmgame {
 
     double getMixedPayoff(int player, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
-      return (double)aggPtr->getMixedPayoff(player,sp);
+      return (double)aggPtr->getMixedPayoff(workspace, player,sp);
     }
 
     double getKSymMixedPayoff(int cls, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
-      return (double) aggPtr->getKSymMixedPayoff(cls,sp);
+      return (double) aggPtr->getKSymMixedPayoff(workspace, cls,sp);
     }
 
     void payoffMatrix(cmatrix &dest, cvector &s, double fuzz);
@@ -90,19 +90,19 @@ class aggame : public gnmgame {
       cvector & ss = const_cast<cvector &>(s);
       std::vector<double> sp (ss.values(), ss.values()+ss.getm());
       std::vector<double> d(aggPtr->getNumActions(player));
-      aggPtr->getPayoffVector(d,player,sp);
+      aggPtr->getPayoffVector(workspace, d,player,sp);
       std::copy(d.begin(),d.end(), dest.values());
     }
     void getSymPayoffVector(cvector& dest, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
       std::vector<double> d(aggPtr->getNumActionNodes());
-      aggPtr->getSymPayoffVector(d,sp);
+      aggPtr->getSymPayoffVector(workspace, d,sp);
       std::copy(d.begin(),d.end(), dest.values());
     }
     void getKSymPayoffVector(cvector &dest, int playerClass, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
       std::vector<double> d (aggPtr->getNumKSymActions(playerClass));
-      aggPtr->getKSymPayoffVector(d,playerClass,sp);
+      aggPtr->getKSymPayoffVector(workspace, d,playerClass,sp);
       std::copy(d.begin(),d.end(), dest.values());
     }
     double getPurePayoff(int player, int* s){
@@ -138,6 +138,10 @@ class aggame : public gnmgame {
 
   private:
 
+    //scratch space for the payoff computations, so that several
+    //aggames can evaluate the same agg at once
+    agg::Workspace workspace;
+
   //helper functions for computing jacobian
     void computePartialP_PureNode(int player,int act,std::vector<int>& tasks);
     void computePartialP_bisect(int player,int act, std::vector<int>::iterator f,std::vector<int>::iterator l,aggdistrib& temp);
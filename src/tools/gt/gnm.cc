@@ -25,17 +25,21 @@
 
 extern bool g_verbose;
 extern int g_numDecimals;
+extern void ReportEquilibrium(const cvector &);
 
 void PrintProfile(std::ostream &p_stream, 
 		  const std::string &p_label,
 		  const cvector &p_profile) 
 {
-  p_stream << p_label;
+  // The line is written at once, as rays may be traced concurrently
+  std::ostringstream line;
+  line << p_label;
   for (int i = 0; i < p_profile.getm(); i++) {
-    p_stream.setf(std::ios::fixed);
-    p_stream << ',' << std::setprecision(g_numDecimals) << p_profile[i];
+    line.setf(std::ios::fixed);
+    line << ',' << std::setprecision(g_numDecimals) << p_profile[i];
   }
-  p_stream << std::endl;
+  line << std::endl;
+  p_stream << line.str() << std::flush;
 }
 
 // gnm(A,g,Eq,steps,fuzz,LNMFreq,LNMMax,LambdaMin,wobble,threshold)
@@ -318,7 +322,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 	    Eq[numEq] = new cvector(M);
 	    *(Eq[numEq++]) = sigma;
 
-	    PrintProfile(std::cout, "NE", sigma);
+	    ReportEquilibrium(sigma);
       }
 	  Index = -Index;
 	  s_hat_old = -1;
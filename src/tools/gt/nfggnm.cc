@@ -26,7 +26,9 @@
 #include <iostream>
 #include <fstream>
 #include <cerrno>
+#include <vector>
 #include "libgambit/libgambit.h"
+#include "libgambit/tasks.h"
 
 #include "nfgame.h"
 #include "aggame.h"
@@ -41,12 +43,21 @@ const int LNMMAX = 10;
 const double LAMBDAMIN = -10.0;
 const bool WOBBLE = false;
 const double THRESHOLD = 1e-2;
+// Equilibria found along different rays closer than this are the same
+const double DUPLICATE = 1e-6;
 
 int g_numDecimals = 6;
 bool g_verbose = false;
 int g_numVectors = 1;
+int g_numThreads = 1;
 std::string g_startFile;
 
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t g_reportLock = PTHREAD_MUTEX_INITIALIZER;
+#endif  // HAVE_PTHREAD_H
+// The equilibria reported so far, when tracing rays concurrently
+std::vector<cvector> g_equilibria;
+
 bool ReadProfile(std::istream &p_stream, cvector &p_profile)
 {
   for (int i = 0; i < p_profile.getm(); i++) {
@@ -70,6 +81,37 @@ bool ReadProfile(std::istream &p_stream, cvector &p_profile)
 extern void PrintProfile(std::ostream &, const std::string &,
 			 const cvector &);
 
+//
+// Called by GNM for each equilibrium found.  When the rays are traced
+// by several threads, the equilibria are reported as they are found,
+// and an equilibrium found along more than one ray is reported once.
+//
+void ReportEquilibrium(const cvector &p_profile)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&g_reportLock);
+#endif  // HAVE_PTHREAD_H
+  bool report = true;
+  if (g_numThreads > 1) {
+    for (size_t e = 0; e < g_equilibria.size() && report; e++) {
+      double dist = 0.0;
+      for (int i = 0; i < p_profile.getm(); i++) {
+	dist = std::max(dist, std::fabs(p_profile[i] - g_equilibria[e][i]));
+      }
+      report = (dist >= DUPLICATE);
+    }
+    if (report) {
+      g_equilibria.push_back(p_profile);
+    }
+  }
+  if (report) {
+    PrintProfile(std::cout, "NE", p_profile);
+  }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&g_reportLock);
+#endif  // HAVE_PTHREAD_H
+}
+
 void PrintBanner(std::ostream &p_stream)
 {
   p_stream << "Compute Nash equilibria using a global Newton method\n";
@@ -88,6 +130,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -d DECIMALS      show equilibria as floating point with DECIMALS digits\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -n COUNT         number of perturbation vectors to generate\n";
+  std::cerr << "  -j THREADS       trace the perturbation vectors using\n";
+  std::cerr << "                   THREADS worker threads\n";
   std::cerr << "  -s FILE          file containing perturbation vectors\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
@@ -96,67 +140,145 @@ void PrintHelp(char *progname)
   exit(1);
 }
 
-void Solve(const Gambit::Game &p_game)
+gnmgame *BuildGame(const Gambit::Game &p_game)
 {
-  int i;
-  gnmgame *A=NULL;
-  if (p_game->IsAgg()){
-	  A = new aggame(dynamic_cast<Gambit::GameAggRep &>(*p_game));
+  if (p_game->IsAgg()) {
+    return new aggame(dynamic_cast<Gambit::GameAggRep &>(*p_game));
   }
-  else {
-    Gambit::Rational maxPay = p_game->GetMaxPayoff();
-    Gambit::Rational minPay = p_game->GetMinPayoff();
-    double scale = 1.0 / (maxPay - minPay);
 
-    int *actions = new int[p_game->NumPlayers()];
-    int veclength = p_game->NumPlayers();
-    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
-      veclength *= p_game->GetPlayer(pl)->NumStrategies();
-    }
-    cvector payoffs(veclength);
+  Gambit::Rational maxPay = p_game->GetMaxPayoff();
+  Gambit::Rational minPay = p_game->GetMinPayoff();
+  double scale = 1.0 / (maxPay - minPay);
+
+  std::vector<int> actions(p_game->NumPlayers());
+  int veclength = p_game->NumPlayers();
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
+    veclength *= p_game->GetPlayer(pl)->NumStrategies();
+  }
+  cvector payoffs(veclength);
   
-    A = new nfgame(p_game->NumPlayers(), actions, payoffs);
+  gnmgame *A = new nfgame(p_game->NumPlayers(), &actions[0], payoffs);
   
-    int *profile = new int[p_game->NumPlayers()];
-    for (Gambit::StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++) {
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-        profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
-      }
+  std::vector<int> profile(p_game->NumPlayers());
+  for (Gambit::StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++) {
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
+    }
 
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-        A->setPurePayoff(pl-1, profile,
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      A->setPurePayoff(pl-1, &profile[0],
 		       (double) ((*iter)->GetPayoff(pl) - minPay) *
 		       scale);
+    }
+  }
+  return A;
+}
+
+//
+// Traces the rays, one per task.  Games keep scratch space for
+// computing payoffs, so each thread takes a game of its own from a
+// pool for the duration of a task.  The games built from an action
+// graph game all share the one loaded game, each with its own
+// workspace.
+//
+class RayTasks {
+public:
+  RayTasks(std::vector<gnmgame *> &p_games, const std::vector<cvector> &p_rays)
+    : m_games(p_games), m_rays(p_rays)
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&m_mutex, 0);
+#endif  // HAVE_PTHREAD_H
+  }
+  ~RayTasks()
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_destroy(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  }
+
+  void operator()(int p_task)
+  {
+    gnmgame *A = Acquire();
+    try {
+      cvector g(m_rays[p_task]);
+      cvector **answers;
+      int numEq = GNM(*A, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX, 
+		      LAMBDAMIN, WOBBLE, THRESHOLD);
+      for (int i = 0; i < numEq; i++) {
+	free(answers[i]);
       }
+      free(answers);
+    }
+    catch (std::exception &e) {
+      Release(A, e.what());
+      return;
+    }
+    Release(A, "");
+  }
+
+  /// Returns the message of the first error raised, if any
+  const std::string &GetError(void) const { return m_error; }
+
+private:
+  std::vector<gnmgame *> &m_games;
+  const std::vector<cvector> &m_rays;
+  std::string m_error;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_t m_mutex;
+#endif  // HAVE_PTHREAD_H
+
+  gnmgame *Acquire(void)
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+    gnmgame *A = m_games.back();
+    m_games.pop_back();
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+    return A;
+  }
+
+  void Release(gnmgame *p_game, const std::string &p_error)
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+    m_games.push_back(p_game);
+    if (m_error.empty() && !p_error.empty()) {
+      m_error = p_error;
     }
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
   }
+};
+
+void Solve(const Gambit::Game &p_game)
+{
+  int i;
+  gnmgame *A = BuildGame(p_game);
 
+  // The rays are all drawn before tracing begins, so they are the
+  // same whatever the number of threads
+  std::vector<cvector> rays;
   cvector g(A->getNumActions()); // choose a random perturbation ray
-  int numEq;
 
   if (g_startFile != "") {
     std::ifstream startVectors(g_startFile.c_str());
 
     while (!startVectors.eof() && !startVectors.bad()) {
-      cvector **answers;
       if (ReadProfile(startVectors, g)) {
 	g /= g.norm(); // normalized
-	if (g_verbose) {
-	  PrintProfile(std::cout, "pert", g);
-	}
-
-	numEq = GNM(*A, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX, LAMBDAMIN, WOBBLE, THRESHOLD);
-	for (i = 0; i < numEq; i++) {
-	  free(answers[i]);
-	}
-	free(answers);
+	rays.push_back(g);
       }
     }
   }
   else {
     for (int iter = 0; iter < g_numVectors; iter++) {
-      cvector **answers;
       for(i = 0; i < A->getNumActions(); i++) {
 #if !defined(HAVE_DRAND48)
 	g[i] = rand();
@@ -165,18 +287,45 @@ void Solve(const Gambit::Game &p_game)
 #endif  // HAVE_DRAND48
       }
       g /= g.norm(); // normalized
+      rays.push_back(g);
+    }
+  }
+
+  if (g_numThreads <= 1 || rays.size() <= 1) {
+    for (size_t ray = 0; ray < rays.size(); ray++) {
       if (g_verbose) {
-	PrintProfile(std::cout, "pert", g);
+	PrintProfile(std::cout, "pert", rays[ray]);
       }
-      numEq = GNM(*A, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX, LAMBDAMIN, WOBBLE, THRESHOLD);
+      cvector **answers;
+      int numEq = GNM(*A, rays[ray], answers, STEPS, FUZZ, LNMFREQ, LNMMAX, 
+		      LAMBDAMIN, WOBBLE, THRESHOLD);
       for (i = 0; i < numEq; i++) {
 	free(answers[i]);
       }
       free(answers);
     }
+    delete A;
+    return;
+  }
+
+  if (g_verbose) {
+    for (size_t ray = 0; ray < rays.size(); ray++) {
+      PrintProfile(std::cout, "pert", rays[ray]);
+    }
   }
 
-  delete A;
+  int numThreads = std::min(g_numThreads, (int) rays.size());
+  std::vector<gnmgame *> games(1, A);
+  for (int t = 1; t < numThreads; t++) {
+    games.push_back(BuildGame(p_game));
+  }
+
+  RayTasks tasks(games, rays);
+  Gambit::RunTasks(tasks, rays.size(), numThreads);
+  for (size_t t = 0; t < games.size(); delete games[t++]);
+  if (!tasks.GetError().empty()) {
+    throw std::runtime_error(tasks.GetError());
+  }
 }
 
 int main(int argc, char *argv[])
@@ -192,7 +341,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:s:qvVhS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:n:j:s:qvVhS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -208,6 +357,9 @@ int main(int argc, char *argv[])
     case 'n':
       g_numVectors = atoi(optarg);
       break;
+    case 'j':
+      g_numThreads = atoi(optarg);
+      break;
     case 's':
       g_startFile = optarg;
       break;
@@ -233,21 +385,11 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) {
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
-    }
-    input_stream = &file_stream;
-  }
-
   try {
-    Gambit::Game game = Gambit::ReadGame(*input_stream);
+    // Files are read by name, which lets them be mapped into memory
+    Gambit::Game game = ((optind < argc) ?
+			  Gambit::ReadGame(std::string(argv[optind])) :
+			  Gambit::ReadGame(std::cin));
     if (!game->IsPerfectRecall()) {
       throw Gambit::UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
     }
@@ -24,7 +24,9 @@
 #include <cstdio>
 #include <unistd.h>
 #include <iostream>
+#include <vector>
 #include "libgambit/libgambit.h"
+#include "libgambit/tasks.h"
 #include "efglcp.h"
 
 using namespace Gambit;
@@ -162,6 +164,85 @@ NashLcpBehaviorSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
 }
 
 
+//
+// Follows a batch of the paths leaving a CBFS, one path per task, so
+// they can be followed by several threads at once.  Each task follows
+// its path on the matrix of its own slot in the batch, perturbed in the
+// row of the path's label; the perturbations are undone by Restore().
+// Errors are recorded, to be raised when the path is reached in order.
+//
+template <class T> class NashLcpBehaviorSolver<T>::PathTasks {
+public:
+  PathTasks(const LTableau<T> &p_start,
+	    const std::vector<Matrix<T> *> &p_matrices,
+	    int p_label, int p_depth, const std::vector<int> &p_rows)
+    : m_start(p_start), m_matrices(p_matrices),
+      m_label(p_label), m_depth(p_depth), m_rows(p_rows),
+      m_tableaus(p_rows.size(), 0),
+      m_found(p_rows.size(), false), m_errors(p_rows.size())
+  { }
+  ~PathTasks()
+  {
+    for (size_t i = 0; i < m_tableaus.size(); delete m_tableaus[i++]);
+    Restore();
+  }
+
+  void operator()(int p_task)
+  {
+    try {
+      Matrix<T> &matrix = *m_matrices[p_task];
+      matrix(m_rows[p_task], 0) = -(T)1/(T)1000;
+      LTableau<T> *tableau = new LTableau<T>(m_start);
+      m_tableaus[p_task] = tableau;
+      tableau->SetMatrix(matrix);
+      tableau->Refactor();
+
+      int missing;
+      if (m_depth == 0) {
+	tableau->Pivot(m_label, 0);
+	missing = -m_label;
+      }
+      else {
+	missing = tableau->SF_PivotIn(0);
+      }
+      m_found[p_task] = (tableau->SF_LCPPath(-missing) == 1);
+    }
+    catch (std::exception &e) {
+      m_errors[p_task] = e.what();
+      if (m_errors[p_task].empty()) {
+	m_errors[p_task] = "Error following Lemke path";
+      }
+    }
+  }
+
+  /// Returns whether the path ends at a CBFS
+  bool IsFound(int p_task) const
+  {
+    if (!m_errors[p_task].empty()) {
+      throw std::runtime_error(m_errors[p_task]);
+    }
+    return m_found[p_task];
+  }
+  LTableau<T> &GetTableau(int p_task) const { return *m_tableaus[p_task]; }
+
+  /// Undoes the perturbations of the matrices
+  void Restore(void)
+  {
+    for (size_t i = 0; i < m_rows.size(); i++) {
+      (*m_matrices[i])(m_rows[i], 0) = (T) -1;
+    }
+  }
+
+private:
+  const LTableau<T> &m_start;
+  const std::vector<Matrix<T> *> &m_matrices;
+  int m_label, m_depth;
+  const std::vector<int> &m_rows;
+  std::vector<LTableau<T> *> m_tableaus;
+  std::vector<bool> m_found;
+  std::vector<std::string> m_errors;
+};
+
 //
 // All_Lemke finds all accessible Nash equilibria by recursively 
 // calling itself.  List maintains the list of basic variables 
@@ -169,6 +250,12 @@ NashLcpBehaviorSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
 // From each new accessible equilibrium, it follows
 // all possible paths, adding any new equilibria to the List.  
 //
+// Only the paths up to the first which finds a new equilibrium are
+// explored.  With several threads, the paths are followed in batches,
+// one per thread; the results of paths past the first new equilibrium
+// in a batch are discarded, so the equilibria are found in the same
+// order, whatever the number of threads.
+//
 template <class T> void
 NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
 				   int j, LTableau<T> &B, int depth,
@@ -179,32 +266,40 @@ NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
     return;
   }
 
-  T small_num = (T)1/(T)1000;
+  std::vector<int> rows;
+  for (int i = B.MinRow(); i <= B.MaxRow(); i++) {
+    if (i != j) {
+      rows.push_back(i);
+    }
+  }
 
   Vector<T> sol(B.MinRow(),B.MaxRow());
   MixedBehaviorProfile<T> profile(p_support);
 
-  bool newsol = false;
-  for (int i = B.MinRow(); i <= B.MaxRow() && !newsol; i++) {
-    if (i == j) continue;
-
-    LTableau<T> BCopy(B);
-    A(i,0) = -small_num;
-    BCopy.Refactor();
-
-    int missing;
-    if (depth == 0) {
-      BCopy.Pivot(j, 0);
-      missing = -j;
-    }
-    else {
-      missing = BCopy.SF_PivotIn(0);
-    }
-
-    newsol = false;
+  // With one thread the paths are followed on A itself, as each is
+  // perturbed and restored in turn.  With several, the tasks of a batch
+  // each have a copy of A, perturbed and restored in the same way.
+  size_t batchSize = std::max(m_numThreads, 1);
+  std::vector<Matrix<T> > copies((batchSize > 1) ? batchSize : 0, A);
+  std::vector<Matrix<T> *> matrices(batchSize, &A);
+  for (size_t i = 0; i < copies.size(); i++) {
+    matrices[i] = &copies[i];
+  }
 
-    if (BCopy.SF_LCPPath(-missing) == 1) {
-      newsol = p_solution.AddBFS(BCopy);
+  for (size_t first = 0; first < rows.size(); first += batchSize) {
+    std::vector<int> batch(rows.begin() + first,
+			   rows.begin() + std::min(first + batchSize,
+						   rows.size()));
+    PathTasks tasks(B, matrices, j, depth, batch);
+    RunTasks(tasks, batch.size(), m_numThreads);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+      if (!tasks.IsFound(i)) {
+	// Dead end
+	continue;
+      }
+      LTableau<T> &BCopy = tasks.GetTableau(i);
+      bool newsol = p_solution.AddBFS(BCopy);
       BCopy.BasisVector(sol);
       GetProfile(p_support, BCopy, profile, sol,
 		 p_support.GetGame()->GetRoot(), 1, 1,
@@ -216,17 +311,13 @@ NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
 	if (m_stopAfter > 0 && p_solution.EquilibriumCount() >= m_stopAfter) {
 	  throw NashEquilibriumLimitReached();
 	}
+	tasks.Restore();
+	BCopy.SetMatrix(A);
+	BCopy.Refactor();
+	AllLemke(p_support, batch[i], BCopy, depth+1, A, p_solution);
+	return;
       }
     }
-    else {
-      // gout << ": Dead End";
-    }
-      
-    A(i,0) = (T) -1;
-    if (newsol) {
-      BCopy.Refactor();
-      AllLemke(p_support, i, BCopy, depth+1, A, p_solution);
-    }
   }
 }
 
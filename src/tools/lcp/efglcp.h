@@ -31,18 +31,20 @@ template <class T> class LTableau;
 
 template <class T> class NashLcpBehaviorSolver : public NashBehavSolver<T> {
 public:
-  NashLcpBehaviorSolver(int p_stopAfter, int p_maxDepth,
+  NashLcpBehaviorSolver(int p_stopAfter, int p_maxDepth, int p_numThreads,
 			Gambit::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0)
     : NashBehavSolver<T>(p_onEquilibrium),
-      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth) { }
+      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth),
+      m_numThreads(p_numThreads) { }
   virtual ~NashLcpBehaviorSolver()  { }
 
   virtual List<MixedBehaviorProfile<T> > Solve(const BehaviorSupportProfile &) const;
 
 private:
-  int m_stopAfter, m_maxDepth;
+  int m_stopAfter, m_maxDepth, m_numThreads;
 
   class Solution;
+  class PathTasks;
 
   void FillTableau(const BehaviorSupportProfile &, Matrix<T> &, const GameNode &, T,
 		   int, int, int, int, Solution &) const;
@@ -21,7 +21,6 @@
 //
 
 #include <iostream>
-#include <fstream>
 #include <cstdlib>
 #include <cerrno>
 #include <unistd.h>
@@ -55,6 +54,8 @@ void PrintHelp(char *progname)
   std::cerr << "                   (default is to find all accessible equilbria\n";
   std::cerr << "  -r DEPTH         terminate recursion at DEPTH\n";
   std::cerr << "                   (only if number of equilibria sought is not 1)\n";
+  std::cerr << "  -j THREADS       follow paths from each equilibrium using\n";
+  std::cerr << "                   THREADS worker threads\n";
   std::cerr << "  -D               print detailed information about equilibria\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
@@ -68,7 +69,7 @@ int main(int argc, char *argv[])
   int c;
   bool useFloat = false, useStrategic = false, bySubgames = false, quiet = false;
   bool printDetail = false;
-  int numDecimals = 6, stopAfter = 0, maxDepth = 0;
+  int numDecimals = 6, stopAfter = 0, maxDepth = 0, numThreads = 1;
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -76,7 +77,7 @@ int main(int argc, char *argv[])
     { "version", 0, NULL, 'v'  },
     { 0,    0,    0,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqSPe:r:", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DvhqSPe:r:j:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -99,6 +100,9 @@ int main(int argc, char *argv[])
     case 'r':
       maxDepth = atoi(optarg);
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
     case 'S':
       useStrategic = true;
       break;
@@ -122,21 +126,11 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) {
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
-    }
-    input_stream = &file_stream;
-  }
-
   try {
-    Game game = ReadGame(*input_stream);
+    // Files are read by name, which lets them be mapped into memory
+    Game game = ((optind < argc) ?
+		  ReadGame(std::string(argv[optind])) :
+		  ReadGame(std::cin));
     if (!game->IsTree() || useStrategic) {
       if (useFloat) {
 	shared_ptr<StrategyProfileRenderer<double> > renderer;
@@ -148,7 +142,7 @@ int main(int argc, char *argv[])
 	  renderer = new MixedStrategyCSVRenderer<double>(std::cout, numDecimals);
 	}
 	NashLcpStrategySolver<double> algorithm(stopAfter, maxDepth,
-						renderer);
+						numThreads, renderer);
 	algorithm.Solve(game);
       }
       else {
@@ -160,7 +154,7 @@ int main(int argc, char *argv[])
 	  renderer = new MixedStrategyCSVRenderer<Rational>(std::cout);
 	}
 	NashLcpStrategySolver<Rational> algorithm(stopAfter, maxDepth,
-						  renderer);
+						  numThreads, renderer);
 	algorithm.Solve(game);
       }
     }
@@ -176,7 +170,8 @@ int main(int argc, char *argv[])
 	    renderer = new BehavStrategyCSVRenderer<double>(std::cout, 
 							    numDecimals);
 	  }
-	  NashLcpBehaviorSolver<double> algorithm(stopAfter, maxDepth, renderer);
+	  NashLcpBehaviorSolver<double> algorithm(stopAfter, maxDepth,
+						  numThreads, renderer);
 	  algorithm.Solve(game);
 	}
 	else {
@@ -187,14 +182,16 @@ int main(int argc, char *argv[])
 	  else {
 	    renderer = new BehavStrategyCSVRenderer<Rational>(std::cout);
 	  }
-	  NashLcpBehaviorSolver<Rational> algorithm(stopAfter, maxDepth, renderer);
+	  NashLcpBehaviorSolver<Rational> algorithm(stopAfter, maxDepth,
+						    numThreads, renderer);
 	  algorithm.Solve(game);
 	}
       }
       else {
 	if (useFloat) {
 	  shared_ptr<NashBehavSolver<double> > stage = 
-	    new NashLcpBehaviorSolver<double>(stopAfter, maxDepth);
+	    new NashLcpBehaviorSolver<double>(stopAfter, maxDepth,
+					      numThreads);
 	  shared_ptr<StrategyProfileRenderer<double> > renderer;
 	  if (printDetail)  {
 	    renderer = new BehavStrategyDetailRenderer<double>(std::cout,
@@ -209,7 +206,8 @@ int main(int argc, char *argv[])
 	}
 	else {
 	  shared_ptr<NashBehavSolver<Rational> > stage = 
-	    new NashLcpBehaviorSolver<Rational>(stopAfter, maxDepth);
+	    new NashLcpBehaviorSolver<Rational>(stopAfter, maxDepth,
+						numThreads);
 	  shared_ptr<StrategyProfileRenderer<Rational> > renderer;
 	  if (printDetail)  {
 	    renderer = new BehavStrategyDetailRenderer<Rational>(std::cout,
@@ -22,5 +22,92 @@
 
 #include "lemketab.imp"
 
+//
+// In the rational case, the columns used in the ratio tests are taken
+// in fraction-free form.  The entries of both columns share the same
+// positive denominator, so the ratios col[i]/incol[i] can be compared
+// by cross-multiplying, without computing any fractions.  Ties are
+// exact, just as for the rational tolerances of zero.
+//
+
+namespace {
+
+//
+// Removes from p_set all rows whose ratio p_col[i]/p_incol[i] is not
+// minimal (if p_max is false) or maximal (if p_max is true).
+// p_incol must be positive on all rows in p_set.
+//
+void SelectRatios(Gambit::Array<int> &p_set,
+		  const Gambit::Vector<Gambit::Integer> &p_col,
+		  const Gambit::Vector<Gambit::Integer> &p_incol,
+		  bool p_max)
+{
+  int best = p_set[1];
+  Gambit::Integer lhs, rhs;
+  for (int i = 2; i <= p_set.Length(); i++) {
+    int k = p_set[i];
+    mul(p_col[k], p_incol[best], lhs);
+    mul(p_col[best], p_incol[k], rhs);
+    if ((p_max) ? lhs > rhs : lhs < rhs) best = k;
+  }
+  for (int i = p_set.Length(); i >= 1; i--) {
+    int k = p_set[i];
+    if (k == best) continue;
+    mul(p_col[k], p_incol[best], lhs);
+    mul(p_col[best], p_incol[k], rhs);
+    if (lhs != rhs) p_set.Remove(i);
+  }
+}
+
+}  // end anonymous namespace
+
+template<> int LTableau<Gambit::Rational>::SF_ExitIndex(int inlabel)
+{
+  Gambit::Array<int> BestSet;
+  Gambit::Vector<Gambit::Integer> incol(MinRow(), MaxRow());
+  Gambit::Vector<Gambit::Integer> col(MinRow(), MaxRow());
+  
+  SolveColumn(inlabel, incol);
+  for (int i = MinRow(); i <= MaxRow(); i++)
+    if (sign(incol[i]) > 0)
+      BestSet.Append(i);
+  if (BestSet.Length() == 0) return 0;
+  
+  int c = MinRow()-1;
+  BasisVector(col);
+  while (BestSet.Length() > 1)   {
+    if (c > MaxRow()) throw BadExitIndex();
+    if (c >= MinRow()) SolveColumn(-c, col);
+    SelectRatios(BestSet, col, incol, false);
+    c++;
+  }
+  return BestSet[1];
+}
+
+template<> int LTableau<Gambit::Rational>::ExitIndex(int inlabel)
+{
+  Gambit::Array<int> BestSet;
+  Gambit::Vector<Gambit::Integer> incol(MinRow(), MaxRow());
+  Gambit::Vector<Gambit::Integer> col(MinRow(), MaxRow());
+  
+  SolveColumn(inlabel, incol);
+  for (int i = MinRow(); i <= MaxRow(); i++)
+    if (sign(incol[i]) > 0)
+      BestSet.Append(i);
+  if (BestSet.Length() == 0 && sign(incol[Find(0)]) == 0)
+    return Find(0);
+  if (BestSet.Length() == 0) throw BadExitIndex();
+  
+  int c = MinRow()-1;
+  BasisVector(col);
+  while (BestSet.Length() > 1)   {
+    if (c > MaxRow()) throw BadExitIndex();
+    if (c >= MinRow()) SolveColumn(-c, col);
+    SelectRatios(BestSet, col, incol, true);
+    c++;
+  }
+  return BestSet[1];
+}
+
 template class LTableau<double>;
 template class LTableau<Gambit::Rational>;
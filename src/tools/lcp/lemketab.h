@@ -52,6 +52,10 @@ public:
   int LemkePath(int dup); // follow a path of ACBFS's from one CBFS to another
 };
 
+// The rational tableau does its ratio tests on the fraction-free columns
+template<> int LTableau<Gambit::Rational>::SF_ExitIndex(int inlabel);
+template<> int LTableau<Gambit::Rational>::ExitIndex(int inlabel);
+
 #endif     // LEMKETAB_H
 
 
@@ -23,8 +23,10 @@
 #include <cstdio>
 #include <unistd.h>
 #include <iostream>
+#include <vector>
 
 #include "libgambit/libgambit.h"
+#include "libgambit/tasks.h"
 #include "nfglcp.h"
 #include "lhtab.h"
 
@@ -110,6 +112,61 @@ NashLcpStrategySolver<T>::OnBFS(const Game &p_game,
   return true;
 }
 
+//
+// Follows a batch of the Lemke paths leaving a CBFS, one path per task,
+// so they can be followed by several threads at once.  The tableau at
+// the end of a path is kept only if its CBFS has not already been found;
+// otherwise there is nothing further to explore from it.  The list of
+// CBFSs found is only read while the tasks run.  Errors are recorded,
+// to be raised when the path is reached in order.
+//
+template <class T> class NashLcpStrategySolver<T>::PathTasks {
+public:
+  PathTasks(const LHTableau<T> &p_start, const Solution &p_solution,
+	    const std::vector<int> &p_labels)
+    : m_start(p_start), m_solution(p_solution), m_labels(p_labels),
+      m_tableaus(p_labels.size(), 0), m_errors(p_labels.size())
+  { }
+  ~PathTasks()
+  { for (size_t i = 0; i < m_tableaus.size(); delete m_tableaus[i++]); }
+
+  void operator()(int p_task)
+  {
+    try {
+      LHTableau<T> *tableau = new LHTableau<T>(m_start);
+      m_tableaus[p_task] = tableau;
+      tableau->LemkePath(m_labels[p_task]);
+      if (m_solution.Contains(tableau->GetBFS())) {
+	delete tableau;
+	m_tableaus[p_task] = 0;
+      }
+    }
+    catch (std::exception &e) {
+      m_errors[p_task] = e.what();
+      if (m_errors[p_task].empty()) {
+	m_errors[p_task] = "Error following Lemke path";
+      }
+    }
+  }
+
+  /// Returns the tableau at the end of the path, or null if there is
+  /// nothing to explore from it
+  LHTableau<T> *GetTableau(int p_task) const
+  {
+    if (!m_errors[p_task].empty()) {
+      throw std::runtime_error(m_errors[p_task]);
+    }
+    return m_tableaus[p_task];
+  }
+
+private:
+  const LHTableau<T> &m_start;
+  const Solution &m_solution;
+  const std::vector<int> &m_labels;
+  std::vector<LHTableau<T> *> m_tableaus;
+  std::vector<std::string> m_errors;
+};
+
 //
 // AllLemke finds all accessible Nash equilibria by recursively 
 // calling itself.  p_list maintains the list of basic variables 
@@ -117,6 +174,11 @@ NashLcpStrategySolver<T>::OnBFS(const Game &p_game,
 // From each new accessible equilibrium, it follows
 // all possible paths, adding any new equilibria to the List.  
 //
+// The paths from an equilibrium are followed in batches, by as many
+// threads as requested, and the ends of the paths in each batch are
+// then explored in order.  The equilibria are found in the same order,
+// whatever the number of threads.
+//
 template <class T> void 
 NashLcpStrategySolver<T>::AllLemke(const Game &p_game,
 				   int j, LHTableau<T> &B,
@@ -132,12 +194,31 @@ NashLcpStrategySolver<T>::AllLemke(const Game &p_game,
   if (depth > 0 && !OnBFS(p_game, B, p_solution)) {
     return;
   }
-  
+  if (m_maxDepth != 0 && depth + 1 > m_maxDepth) {
+    // The ends of the paths would not be explored
+    return;
+  }
+
+  std::vector<int> labels;
   for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
     if (i != j)  {
-      LHTableau<T> Bcopy(B);
-      Bcopy.LemkePath(i);
-      AllLemke(p_game, i, Bcopy, p_solution, depth+1);
+      labels.push_back(i);
+    }
+  }
+
+  // Several paths per thread in each batch help balance the load,
+  // as paths vary in length
+  int batchSize = (m_numThreads > 1) ? 4 * m_numThreads : 1;
+  for (size_t first = 0; first < labels.size(); first += batchSize) {
+    std::vector<int> batch(labels.begin() + first,
+			   labels.begin() + std::min(first + batchSize,
+						     labels.size()));
+    PathTasks tasks(B, p_solution, batch);
+    RunTasks(tasks, batch.size(), m_numThreads);
+    for (size_t i = 0; i < batch.size(); i++) {
+      if (LHTableau<T> *Bcopy = tasks.GetTableau(i)) {
+	AllLemke(p_game, batch[i], *Bcopy, p_solution, depth+1);
+      }
     }
   }
 }
@@ -31,18 +31,20 @@ template <class T> class LHTableau;
 
 template <class T> class NashLcpStrategySolver : public NashStrategySolver<T> {
 public:
-  NashLcpStrategySolver(int p_stopAfter, int p_maxDepth,
+  NashLcpStrategySolver(int p_stopAfter, int p_maxDepth, int p_numThreads,
 			Gambit::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0)
     : NashStrategySolver<T>(p_onEquilibrium),
-      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth) { }
+      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth),
+      m_numThreads(p_numThreads) { }
   virtual ~NashLcpStrategySolver()  { }
 
   virtual List<MixedStrategyProfile<T> > Solve(const Game &) const;
 
 private:
-  int m_stopAfter, m_maxDepth;
+  int m_stopAfter, m_maxDepth, m_numThreads;
 
   class Solution;
+  class PathTasks;
 
   bool OnBFS(const Game &, LHTableau<T> &, Solution &) const;
   void AllLemke(const Game &, int j, LHTableau<T> &, Solution &, int) const;
@@ -53,7 +53,7 @@ private:
 
 double AgentLyapunovFunction::Value(const Vector<double> &v) const
 {
-  static_cast<Vector<double> &>(m_profile).operator=(v);
+  m_profile = v;
   return m_profile.GetLiapValue();
 }
 
@@ -61,14 +61,22 @@ bool AgentLyapunovFunction::Gradient(const Vector<double> &x,
 				     Vector<double> &grad) const
 {
   const double DELTA = .00001;
-  static_cast<Vector<double> &>(m_profile).operator=(x);
-  for (int i = 1; i <= x.Length(); i++) {
-    m_profile[i] += DELTA;
-    double value = m_profile.GetLiapValue();
-    m_profile[i] -= 2.0 * DELTA;
-    value -= m_profile.GetLiapValue();
-    m_profile[i] += DELTA;
-    grad[i] = value / (2.0 * DELTA);
+  m_profile = x;
+  // Each perturbation changes a single information set, so the profile
+  // recomputes only the parts of the tree which that set affects
+  int i = 1;
+  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
+    for (int iset = 1; iset <= m_game->GetPlayer(pl)->NumInfosets(); iset++) {
+      for (int act = 1; act <= m_profile.GetSupport().NumActions(pl, iset);
+	   act++, i++) {
+	m_profile(pl, iset, act) += DELTA;
+	double value = m_profile.GetLiapValue();
+	m_profile(pl, iset, act) -= 2.0 * DELTA;
+	value -= m_profile.GetLiapValue();
+	m_profile(pl, iset, act) += DELTA;
+	grad[i] = value / (2.0 * DELTA);
+      }
+    }
   }
   Project(grad, m_game->NumInfosets());
   return true;
@@ -116,8 +124,18 @@ NashLiapBehavSolver::Solve(const MixedBehaviorProfile<double> &p_start) const
     }
     
     if (sqrt(gradient.NormSquared()) < .001) {
-      this->m_onEquilibrium->Render(p, "NE");
-      solutions.push_back(p);
+      // When other starting points are being minimized alongside this
+      // one, only the first to arrive at an equilibrium reports it
+      if (!m_known || m_known->Insert(p)) {
+	this->m_onEquilibrium->Render(p, "NE");
+	solutions.push_back(p);
+      }
+      break;
+    }
+
+    if (m_known && iter % KNOWN_CHECK_INTERVAL == 0 &&
+	m_known->Contains(p)) {
+      // Converging to an equilibrium already found; abandon this start
       break;
     }
   }
@@ -24,15 +24,17 @@
 #define EFGLIAP_H
 
 #include "libgambit/nash.h"
+#include "equilibria.h"
 
 using namespace Gambit;
 
 class NashLiapBehavSolver : public NashBehavSolver<double> {
 public:
   NashLiapBehavSolver(int p_maxitsN, bool p_verbose = false,
-		      shared_ptr<StrategyProfileRenderer<double> > p_onEquilibrium = 0)
+		      shared_ptr<StrategyProfileRenderer<double> > p_onEquilibrium = 0,
+		      EquilibriumSet *p_known = 0)
     : NashBehavSolver<double>(p_onEquilibrium),
-      m_maxitsN(p_maxitsN), m_verbose(p_verbose)
+      m_maxitsN(p_maxitsN), m_verbose(p_verbose), m_known(p_known)
   { }
   virtual ~NashLiapBehavSolver() { }
 
@@ -43,6 +45,7 @@ public:
 private:
   int m_maxitsN;
   bool m_verbose;
+  EquilibriumSet *m_known;
 };
 
 #endif  // EFGLIAP_H
@@ -0,0 +1,119 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/liap/equilibria.h
+// Equilibria found so far, shared among concurrent minimizations
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef EQUILIBRIA_H
+#define EQUILIBRIA_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "libgambit/libgambit.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
+
+using namespace Gambit;
+
+// A minimization checks whether it is converging to an equilibrium
+// already found once in this many iterations, since each check takes
+// the set's lock and compares against every equilibrium in it
+const int KNOWN_CHECK_INTERVAL = 10;
+
+//
+// The equilibria found so far from any starting point.  Points are
+// compared in the max-norm; two points closer than the tolerance are
+// taken to be the same equilibrium.  All members may be called
+// concurrently.
+//
+class EquilibriumSet {
+public:
+  EquilibriumSet(double p_tolerance) : m_tolerance(p_tolerance)
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&m_mutex, 0);
+#endif  // HAVE_PTHREAD_H
+  }
+  ~EquilibriumSet()
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_destroy(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  }
+
+  /// Returns true if the point is close to an equilibrium already found
+  bool Contains(const Vector<double> &p_point) const
+  {
+    Lock();
+    bool found = Find(p_point);
+    Unlock();
+    return found;
+  }
+
+  /// Adds the equilibrium, returning false if it had already been found
+  bool Insert(const Vector<double> &p_point)
+  {
+    Lock();
+    bool found = Find(p_point);
+    if (!found) {
+      m_points.push_back(p_point);
+    }
+    Unlock();
+    return !found;
+  }
+
+private:
+  double m_tolerance;
+  std::vector<Vector<double> > m_points;
+#ifdef HAVE_PTHREAD_H
+  mutable pthread_mutex_t m_mutex;
+#endif  // HAVE_PTHREAD_H
+
+  void Lock(void) const
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  }
+  void Unlock(void) const
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  }
+
+  bool Find(const Vector<double> &p_point) const
+  {
+    for (size_t e = 0; e < m_points.size(); e++) {
+      double dist = 0.0;
+      for (int i = 1; i <= p_point.Length(); i++) {
+	dist = std::max(dist, std::fabs(p_point[i] - m_points[e][i]));
+      }
+      if (dist < m_tolerance) {
+	return true;
+      }
+    }
+    return false;
+  }
+};
+
+#endif  // EQUILIBRIA_H
@@ -22,16 +22,22 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cerrno>
 #include <cstdlib>
 #include <unistd.h>
 #include <getopt.h>
 #include "libgambit/libgambit.h"
+#include "libgambit/tasks.h"
 #include "efgliap.h"
 #include "nfgliap.h"
 
 using namespace Gambit;
 
+// Equilibria found from different starting points closer than this
+// are the same
+const double DUPLICATE = 1e-3;
+
 void PrintBanner(std::ostream &p_stream)
 {
   p_stream << "Compute Nash equilibria by minimizing the Lyapunov function\n";
@@ -49,6 +55,8 @@ void PrintHelp(char *progname)
   std::cerr << "Options:\n";
   std::cerr << "  -d DECIMALS      print probabilities with DECIMALS digits\n";
   std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -j THREADS       minimize from the starting points using\n";
+  std::cerr << "                   THREADS worker threads\n";
   std::cerr << "  -n COUNT         number of starting points to generate\n";
   std::cerr << "  -s FILE          file containing starting points\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
@@ -130,6 +138,176 @@ RandomBehaviorProfiles(const Game &p_game, int p_count)
   return profiles;
 }
 
+//
+// Reads the game named on the command line, or else from standard
+// input, or, once standard input has been read in full, from p_input.
+//
+Game ReadCopy(int argc, char *argv[], const std::string &p_input)
+{
+  if (optind < argc) {
+    // Files are read by name, which lets them be mapped into memory
+    return ReadGame(std::string(argv[optind]));
+  }
+  else if (!p_input.empty()) {
+    std::istringstream stream(p_input);
+    return ReadGame(stream);
+  }
+  else {
+    return ReadGame(std::cin);
+  }
+}
+
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t g_outputLock = PTHREAD_MUTEX_INITIALIZER;
+#endif  // HAVE_PTHREAD_H
+
+//
+// Writes each profile out whole, when several threads are reporting
+// their profiles at once.
+//
+class LockedRenderer : public StrategyProfileRenderer<double> {
+public:
+  LockedRenderer(shared_ptr<StrategyProfileRenderer<double> > p_renderer)
+    : m_renderer(p_renderer) { }
+  virtual ~LockedRenderer() { }
+
+  void Render(const MixedStrategyProfile<double> &p_profile,
+	      const std::string &p_label = "NE") const
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&g_outputLock);
+#endif  // HAVE_PTHREAD_H
+    m_renderer->Render(p_profile, p_label);
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&g_outputLock);
+#endif  // HAVE_PTHREAD_H
+  }
+  void Render(const MixedBehaviorProfile<double> &p_profile,
+	      const std::string &p_label = "NE") const
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&g_outputLock);
+#endif  // HAVE_PTHREAD_H
+    m_renderer->Render(p_profile, p_label);
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&g_outputLock);
+#endif  // HAVE_PTHREAD_H
+  }
+
+private:
+  shared_ptr<StrategyProfileRenderer<double> > m_renderer;
+};
+
+//
+// Minimizes from each of the starting points, on worker threads if
+// there are several games to minimize on.  Games keep unsynchronized
+// reference counts and caches, so each thread takes a copy of the game
+// of its own from a pool for the duration of a task.  An equilibrium
+// found from more than one starting point is reported once, and a
+// minimization which comes close to an equilibrium already reported
+// is abandoned.
+//
+class StartTasks {
+public:
+  StartTasks(std::vector<Game> &p_games,
+	     const std::vector<Vector<double> > &p_starts,
+	     bool p_useStrategic, int p_maxitsN, bool p_verbose,
+	     int p_numDecimals)
+    : m_games(p_games), m_starts(p_starts), m_useStrategic(p_useStrategic),
+      m_maxitsN(p_maxitsN), m_verbose(p_verbose),
+      m_numDecimals(p_numDecimals), m_known(DUPLICATE)
+  {
+    // Games are handed out by index, so each game's handle (and so its
+    // reference count) is only ever touched by the one thread using it
+    for (size_t g = 0; g < m_games.size(); m_free.push_back(g++));
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&m_mutex, 0);
+#endif  // HAVE_PTHREAD_H
+  }
+  ~StartTasks()
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_destroy(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  }
+
+  void operator()(int p_task)
+  {
+    int game = Acquire();
+    try {
+      shared_ptr<StrategyProfileRenderer<double> > renderer;
+      if (m_useStrategic) {
+	renderer = new LockedRenderer(new MixedStrategyCSVRenderer<double>(std::cout,
+									   m_numDecimals));
+	MixedStrategyProfile<double> start =
+	  m_games[game]->NewMixedStrategyProfile(0.0);
+	static_cast<Vector<double> &>(start) = m_starts[p_task];
+	NashLiapStrategySolver algorithm(m_maxitsN, m_verbose, renderer,
+					 &m_known);
+	algorithm.Solve(start);
+      }
+      else {
+	renderer = new LockedRenderer(new BehavStrategyCSVRenderer<double>(std::cout,
+									   m_numDecimals));
+	MixedBehaviorProfile<double> start(m_games[game]);
+	static_cast<Vector<double> &>(start) = m_starts[p_task];
+	NashLiapBehavSolver algorithm(m_maxitsN, m_verbose, renderer,
+				      &m_known);
+	algorithm.Solve(start);
+      }
+    }
+    catch (std::exception &e) {
+      Release(game, e.what());
+      return;
+    }
+    Release(game, "");
+  }
+
+  /// Returns the message of the first error raised, if any
+  const std::string &GetError(void) const { return m_error; }
+
+private:
+  std::vector<Game> &m_games;
+  const std::vector<Vector<double> > &m_starts;
+  bool m_useStrategic;
+  int m_maxitsN;
+  bool m_verbose;
+  int m_numDecimals;
+  EquilibriumSet m_known;
+  std::vector<int> m_free;
+  std::string m_error;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_t m_mutex;
+#endif  // HAVE_PTHREAD_H
+
+  int Acquire(void)
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+    int game = m_free.back();
+    m_free.pop_back();
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+    return game;
+  }
+
+  void Release(int p_game, const std::string &p_error)
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+    m_free.push_back(p_game);
+    if (m_error.empty() && !p_error.empty()) {
+      m_error = p_error;
+    }
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  }
+};
+
 int main(int argc, char *argv[])
 {
   opterr = 0;
@@ -137,6 +315,7 @@ int main(int argc, char *argv[])
   int numTries = 10;
   int maxitsN = 100;
   int numDecimals = 6;
+  int numThreads = 1;
   double tolN = 1.0e-10;
   std::string startFile = "";
  
@@ -148,13 +327,16 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:s:hqVvS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:j:n:s:hqVvS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
     case 'd':
       numDecimals = atoi(optarg);
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
     case 'n':
       numTries = atoi(optarg);
       break;
@@ -190,22 +372,23 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) {
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
+  try {
+    // Each worker thread reads a copy of the game of its own, so a game
+    // on standard input is kept to be read again
+    std::string input;
+    if (numThreads > 1 && optind >= argc) {
+      std::ostringstream buffer;
+      buffer << std::cin.rdbuf();
+      input = buffer.str();
     }
-    input_stream = &file_stream;
-  }
 
-  try {
-    Game game = ReadGame(*input_stream);
-    if (!game->IsTree() || useStrategic) {
+    Game game = ReadCopy(argc, argv, input);
+    bool strategic = !game->IsTree() || useStrategic;
+    std::vector<Vector<double> > points;
+    if (strategic) {
+      // Minimization evaluates the payoff functions many times over
+      game->SetCompiledPayoffs(true);
+
       List<MixedStrategyProfile<double> > starts;
       if (startFile != "") {
 	std::ifstream startPoints(startFile.c_str());
@@ -217,11 +400,7 @@ int main(int argc, char *argv[])
       }
 
       for (int i = 1; i <= starts.size(); i++) {
-	shared_ptr<StrategyProfileRenderer<double> > renderer;
-	renderer = new MixedStrategyCSVRenderer<double>(std::cout,
-							numDecimals);
-	NashLiapStrategySolver algorithm(maxitsN, verbose, renderer);
-	algorithm.Solve(starts[i]);
+	points.push_back(starts[i]);
       }
     }
     else {
@@ -236,13 +415,27 @@ int main(int argc, char *argv[])
       }
 
       for (int i = 1; i <= starts.size(); i++) {
-	shared_ptr<StrategyProfileRenderer<double> > renderer;
-	renderer = new BehavStrategyCSVRenderer<double>(std::cout,
-							numDecimals);
-	NashLiapBehavSolver algorithm(maxitsN, verbose, renderer);
-	algorithm.Solve(starts[i]);
+	points.push_back(starts[i]);
+      }
+    }
+
+    // The starting points are all drawn before minimization begins, so
+    // they are the same whatever the number of threads
+    numThreads = std::max(1, std::min(numThreads, (int) points.size()));
+    std::vector<Game> games(1, game);
+    for (int t = 1; t < numThreads; t++) {
+      games.push_back(ReadCopy(argc, argv, input));
+      if (strategic) {
+	games.back()->SetCompiledPayoffs(true);
       }
     }
+
+    StartTasks tasks(games, points, strategic, maxitsN, verbose,
+		     numDecimals);
+    RunTasks(tasks, points.size(), numThreads);
+    if (!tasks.GetError().empty()) {
+      throw std::runtime_error(tasks.GetError());
+    }
     return 0;
   }
   catch (std::runtime_error &e) {
@@ -38,60 +38,62 @@ using namespace Gambit;
 class StrategicLyapunovFunction : public FunctionOnSimplices {
 public:
   StrategicLyapunovFunction(const MixedStrategyProfile<double> &p_start)
-    : m_game(p_start.GetGame()), m_profile(p_start)
+    : m_game(p_start.GetGame()), m_profile(p_start),
+      m_payoffs(p_start.MixedProfileLength()),
+      m_payoffs2(p_start.MixedProfileLength(), p_start.MixedProfileLength())
   { }
   virtual ~StrategicLyapunovFunction() { }
 
 private:
   Game m_game;
   mutable MixedStrategyProfile<double> m_profile;
+  /// Workspace for the first and second payoff derivatives
+  mutable Vector<double> m_payoffs;
+  mutable Matrix<double> m_payoffs2;
 
   double Value(const Vector<double> &) const;
   bool Gradient(const Vector<double> &, Vector<double> &) const;
-
-  double LiapDerivValue(int, int, const MixedStrategyProfile<double> &) const;
 };
 
-double 
-StrategicLyapunovFunction::LiapDerivValue(int i1, int j1,
-					  const MixedStrategyProfile<double> &p) const
+//
+// The derivative with respect to each strategy is accumulated one
+// player at a time, so that all the payoff derivatives for that
+// player can be computed together.
+//
+bool 
+StrategicLyapunovFunction::Gradient(const Vector<double> &v, Vector<double> &d) const
 {
-  GameStrategy wrt_strategy = m_game->Players()[i1]->Strategies()[j1];
-  double x = 0.0;
-  for (int i = 1; i <= m_game->NumPlayers(); i++)  {
-    double psum = 0.0;
+  static_cast<Vector<double> &>(m_profile).operator=(v);
+  d = 0.0;
+  for (int i = 1, first = 1; i <= m_game->NumPlayers(); i++) {
     GamePlayer player = m_game->Players()[i];
-    for (int j = 1; j <= player->NumStrategies(); j++)  {
-      GameStrategy strategy = player->Strategies()[j];
-      psum += p[strategy];
-      double x1 = p.GetPayoff(strategy) - p.GetPayoff(i);
-      if (i1 == i) {
-	if (x1 > 0.0)
-	  x -= x1 * p.GetPayoffDeriv(i, wrt_strategy);
-      }
-      else if (x1 > 0.0) {
-	x += x1 * (p.GetPayoffDeriv(i, strategy, wrt_strategy) - 
-		   p.GetPayoffDeriv(i, wrt_strategy));
+    int last = first + player->NumStrategies() - 1;
+    m_profile.GetPayoffDerivs(i, m_payoffs, m_payoffs2);
+    double payoff = m_profile.GetPayoff(i);
+    double psum = 0.0;
+    for (int j = first; j <= last; j++)  {
+      psum += v[j];
+      double x1 = m_payoffs[j] - payoff;
+      if (x1 <= 0.0) continue;
+      for (int k = 1; k <= d.Length(); k++) {
+	if (k >= first && k <= last) {
+	  d[k] -= x1 * m_payoffs[k];
+	}
+	else {
+	  d[k] += x1 * (m_payoffs2(j, k) - m_payoffs[k]);
+	}
       }
     }
-    if (i == i1)  {
-      x += 100.0 * (psum - 1.0);
+    for (int k = first; k <= last; k++) {
+      d[k] += 100.0 * (psum - 1.0);
     }
+    first = last + 1;
   }
-  if (p[wrt_strategy] < 0.0) {
-    x += p[wrt_strategy];
-  }
-  return 2.0 * x;
-}
-
-bool 
-StrategicLyapunovFunction::Gradient(const Vector<double> &v, Vector<double> &d) const
-{
-  static_cast<Vector<double> &>(m_profile).operator=(v);
-  for (int pl = 1, ii = 1; pl <= m_game->NumPlayers(); pl++) {
-    for (int st = 1; st <= m_game->Players()[pl]->Strategies().size(); st++) {
-      d[ii++] = LiapDerivValue(pl, st, m_profile);
+  for (int k = 1; k <= d.Length(); k++) {
+    if (v[k] < 0.0) {
+      d[k] += v[k];
     }
+    d[k] *= 2.0;
   }
   Project(d, m_game->NumStrategies());
   return true;
@@ -145,8 +147,18 @@ NashLiapStrategySolver::Solve(const MixedStrategyProfile<double> &p_start) const
     }
 
     if (sqrt(gradient.NormSquared()) < .001) {
-      this->m_onEquilibrium->Render(p, "NE");
-      solutions.push_back(p);
+      // When other starting points are being minimized alongside this
+      // one, only the first to arrive at an equilibrium reports it
+      if (!m_known || m_known->Insert((const Vector<double> &) p)) {
+	this->m_onEquilibrium->Render(p, "NE");
+	solutions.push_back(p);
+      }
+      break;
+    }
+
+    if (m_known && iter % KNOWN_CHECK_INTERVAL == 0 &&
+	m_known->Contains((const Vector<double> &) p)) {
+      // Converging to an equilibrium already found; abandon this start
       break;
     }
   }
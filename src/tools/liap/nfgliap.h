@@ -24,15 +24,17 @@
 #define NFGLIAP_H
 
 #include "libgambit/nash.h"
+#include "equilibria.h"
 
 using namespace Gambit;
 
 class NashLiapStrategySolver : public NashStrategySolver<double> {
 public:
   NashLiapStrategySolver(int p_maxitsN, bool p_verbose = false,
-			 shared_ptr<StrategyProfileRenderer<double> > p_onEquilibrium = 0)
+			 shared_ptr<StrategyProfileRenderer<double> > p_onEquilibrium = 0,
+			 EquilibriumSet *p_known = 0)
     : NashStrategySolver<double>(p_onEquilibrium),
-      m_maxitsN(p_maxitsN), m_verbose(p_verbose)
+      m_maxitsN(p_maxitsN), m_verbose(p_verbose), m_known(p_known)
   { }
   virtual ~NashLiapStrategySolver() { }
 
@@ -43,6 +45,7 @@ public:
 private:
   int m_maxitsN;
   bool m_verbose;
+  EquilibriumSet *m_known;
 };
 
 #endif  // NFGLIAP_H
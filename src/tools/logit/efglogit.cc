@@ -103,12 +103,23 @@ private:
 		  Vector<double> &p_gradient) const;
   };
 
+  // Load the point into the scratch profile, unless it is already there
+  void SetPoint(const Vector<double> &p_point) const;
+
   Array<Equation *> m_equations;
-  const Game &m_game;
+  Game m_game;
+  // Scratch space, reused across evaluations.  Keeping the profile alive
+  // lets the value at a point reuse the solution data computed for the
+  // Jacobian at the same point.
+  mutable LogBehavProfile<double> m_profile;
+  mutable Vector<double> m_point, m_column;
+  mutable bool m_pointValid;
 };
 
 AgentQREPathTracer::EquationSystem::EquationSystem(const Game &p_game)
-  : m_game(p_game)
+  : m_game(p_game), m_profile(p_game),
+    m_point(m_profile.Length() + 1), m_column(m_profile.Length() + 1),
+    m_pointValid(false)
 {
   for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
     GamePlayer player = m_game->GetPlayer(pl);
@@ -219,18 +230,25 @@ AgentQREPathTracer::EquationSystem::RatioEquation::Gradient(const LogBehavProfil
 
 
 void
-AgentQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
-					     Vector<double> &p_lhs) const
+AgentQREPathTracer::EquationSystem::SetPoint(const Vector<double> &p_point) const
 {
-  LogBehavProfile<double> profile(m_game);
-  for (int i = 1; i <= profile.Length(); i++) {
-    profile.SetLogProb(i, p_point[i]);
+  if (m_pointValid && m_point == p_point)  return;
+  for (int i = 1; i <= m_profile.Length(); i++) {
+    m_profile.SetLogProb(i, p_point[i]);
   }
+  m_point = p_point;
+  m_pointValid = true;
+}
 
+void
+AgentQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
+					     Vector<double> &p_lhs) const
+{
+  SetPoint(p_point);
   double lambda = p_point[p_point.Length()];
 
   for (int i = 1; i <= p_lhs.Length(); i++) {
-    p_lhs[i] = m_equations[i]->Value(profile, lambda);
+    p_lhs[i] = m_equations[i]->Value(m_profile, lambda);
   }
 }
 
@@ -238,16 +256,12 @@ void
 AgentQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_point, 
 						Matrix<double> &p_matrix) const
 {
-  LogBehavProfile<double> profile(m_game);
-  for (int i = 1; i <= profile.Length(); i++) {
-    profile.SetLogProb(i, p_point[i]);
-  }
+  SetPoint(p_point);
   double lambda = p_point[p_point.Length()];
 
   for (int i = 1; i <= m_equations.Length(); i++) {
-    Vector<double> column(p_point.Length());
-    m_equations[i]->Gradient(profile, lambda, column);
-    p_matrix.SetColumn(i, column);
+    m_equations[i]->Gradient(m_profile, lambda, m_column);
+    p_matrix.SetColumn(i, m_column);
   }
 }
 
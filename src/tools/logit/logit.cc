@@ -52,10 +52,12 @@ void PrintHelp(char *progname)
   std::cerr << "  -d DECIMALS      show equilibria as floating point with DECIMALS digits\n";
   std::cerr << "  -s STEP          initial stepsize (default is .03)\n";
   std::cerr << "  -a ACCEL         maximum acceleration (default is 1.1)\n";
+  std::cerr << "  -A               use adaptive higher-order predictor and stepsize\n";
   std::cerr << "  -m MAXLAMBDA     stop when reaching MAXLAMBDA (default is 1000000)\n";
   std::cerr << "  -l LAMBDA        compute QRE at `lambda` accurately\n";
   std::cerr << "  -L FILE          compute maximum likelihood estimates;\n";
   std::cerr << "                   read strategy frequencies from FILE\n";
+  std::cerr << "                   (with several lines, estimate for each)\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -e               print only the terminal equilibrium\n";
@@ -75,6 +77,9 @@ bool ReadProfile(std::istream &p_stream, Vector<double> &p_profile)
     }
 
     p_stream >> p_profile[i];
+    if (p_stream.fail()) {
+      return false;
+    }
     if (i < p_profile.Length()) {
       char comma;
       p_stream >> comma;
@@ -96,6 +101,7 @@ int main(int argc, char *argv[])
   std::string mleFile = "";
   double maxDecel = 1.1;
   double hStart = 0.03;
+  bool adaptive = false;
   double targetLambda = -1.0;
   bool fullGraph = true;
   int decimals = 6;
@@ -107,7 +113,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:s:a:m:vqehSL:p:l:", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:s:a:Am:vqehSL:p:l:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -123,6 +129,9 @@ int main(int argc, char *argv[])
     case 'a':
       maxDecel = atof(optarg);
       break;
+    case 'A':
+      adaptive = true;
+      break;
     case 'm':
       maxLambda = atof(optarg);
       break;
@@ -158,37 +167,44 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) { 
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
-    }
-    input_stream = &file_stream;
-  }
-
   try {
-    Game game = ReadGame(*input_stream);
+    // Files are read by name, which lets them be mapped into memory
+    Game game = ((optind < argc) ?
+		  ReadGame(std::string(argv[optind])) :
+		  ReadGame(std::cin));
     if (!game->IsPerfectRecall()) {
       throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
     }
 
+    if (!game->IsTree() || useStrategic) {
+      // Tracing evaluates the payoff functions many times over
+      game->SetCompiledPayoffs(true);
+    }
+
     if (mleFile != "" && (!game->IsTree() || useStrategic)) {
-      MixedStrategyProfile<double> frequencies(game->NewMixedStrategyProfile(0.0));
+      // Each line of the file is a separate set of observed frequencies
+      List<MixedStrategyProfile<double> > frequencies;
+      MixedStrategyProfile<double> profile(game->NewMixedStrategyProfile(0.0));
       std::ifstream mleData(mleFile.c_str());
-      ReadProfile(mleData, frequencies);
+      ReadProfile(mleData, profile);
+      frequencies.Append(profile);
+      while (ReadProfile(mleData, profile)) {
+	frequencies.Append(profile);
+      }
 
       LogitQREMixedStrategyProfile start(game);
       StrategicQREEstimator tracer;
       tracer.SetMaxDecel(maxDecel);
       tracer.SetStepsize(hStart);
+      tracer.SetAdaptive(adaptive);
       tracer.SetFullGraph(fullGraph);
       tracer.SetDecimals(decimals);
-      tracer.Estimate(start, frequencies, std::cout, maxLambda, 1.0);
+      if (frequencies.Length() > 1) {
+	tracer.Estimate(start, frequencies, std::cout, maxLambda, 1.0);
+      }
+      else {
+	tracer.Estimate(start, frequencies[1], std::cout, maxLambda, 1.0);
+      }
       return 0;
     }
 
@@ -197,6 +213,7 @@ int main(int argc, char *argv[])
       StrategicQREPathTracer tracer;
       tracer.SetMaxDecel(maxDecel);
       tracer.SetStepsize(hStart);
+      tracer.SetAdaptive(adaptive);
       tracer.SetFullGraph(fullGraph);
       tracer.SetDecimals(decimals);
       if (targetLambda > 0.0) {
@@ -211,6 +228,7 @@ int main(int argc, char *argv[])
       AgentQREPathTracer tracer;
       tracer.SetMaxDecel(maxDecel);
       tracer.SetStepsize(hStart);
+      tracer.SetAdaptive(adaptive);
       tracer.SetFullGraph(fullGraph);
       tracer.SetDecimals(decimals);
       tracer.TraceAgentPath(start, std::cout, maxLambda, 1.0, targetLambda);
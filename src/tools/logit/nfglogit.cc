@@ -36,7 +36,7 @@ namespace Gambit {
 
 class StrategicQREPathTracer::EquationSystem : public PathTracer::EquationSystem {
 public:
-  EquationSystem(const Game &p_game) : m_game(p_game) { }
+  EquationSystem(const Game &p_game);
   virtual ~EquationSystem() { }
   // Compute the value of the system of equations at the specified point.
   virtual void GetValue(const Vector<double> &p_point,
@@ -46,37 +46,77 @@ public:
 			   Matrix<double> &p_matrix) const;
 
 private:
-  const Game &m_game;
+  // Load the point into the scratch profile, unless it is already there
+  void SetPoint(const Vector<double> &p_point) const;
+
+  Game m_game;
+  // Scratch space, reused across evaluations.  The tracer asks for the
+  // Jacobian and then the value at the same point, so the strategy
+  // payoffs computed for the Jacobian are kept for the value.
+  mutable MixedStrategyProfile<double> m_profile;
+  mutable Vector<double> m_point;
+  mutable bool m_pointValid, m_payoffsValid;
+  mutable Vector<double> m_strategyPayoffs, m_payoffs;
+  mutable Matrix<double> m_payoffs2;
 };
 
+StrategicQREPathTracer::EquationSystem::EquationSystem(const Game &p_game)
+  : m_game(p_game), m_profile(p_game->NewMixedStrategyProfile(0.0)),
+    m_point(m_profile.MixedProfileLength() + 1),
+    m_pointValid(false), m_payoffsValid(false),
+    m_strategyPayoffs(m_profile.MixedProfileLength()),
+    m_payoffs(m_profile.MixedProfileLength()),
+    m_payoffs2(m_profile.MixedProfileLength(), m_profile.MixedProfileLength())
+{ }
+
+void
+StrategicQREPathTracer::EquationSystem::SetPoint(const Vector<double> &p_point) const
+{
+  if (m_pointValid && m_point == p_point)  return;
+  for (int i = 1; i <= m_profile.MixedProfileLength(); i++) {
+    m_profile[i] = exp(p_point[i]);
+  }
+  m_point = p_point;
+  m_pointValid = true;
+  m_payoffsValid = false;
+}
+
 void 
 StrategicQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
 						 Vector<double> &p_lhs) const
 {
-  MixedStrategyProfile<double> profile(m_game->NewMixedStrategyProfile(0.0)), logprofile(m_game->NewMixedStrategyProfile(0.0));
-  for (int i = 1; i <= profile.MixedProfileLength(); i++) {
-    profile[i] = exp(p_point[i]);
-    logprofile[i] = p_point[i];
+  SetPoint(p_point);
+  if (!m_payoffsValid) {
+    for (int rowno = 0, pl = 1; pl <= m_game->NumPlayers(); pl++) {
+      m_profile.GetPayoffDerivs(pl, m_payoffs);
+      for (int st = 1; st <= m_game->Players()[pl]->Strategies().size(); st++) {
+	rowno++;
+	m_strategyPayoffs[rowno] = m_payoffs[rowno];
+      }
+    }
+    m_payoffsValid = true;
   }
+
   double lambda = p_point[p_point.Length()];
   p_lhs = 0.0;
   for (int rowno = 0, pl = 1; pl <= m_game->NumPlayers(); pl++) {
     GamePlayer player = m_game->Players()[pl];
+    // Index in the profile of the player's first strategy
+    int first = rowno + 1;
     for (int st = 1; st <= player->Strategies().size(); st++) {
       rowno++;
       if (st == 1) {
 	// This is a sum-to-one equation
 	p_lhs[rowno] = -1.0;
 	for (int j = 1; j <= player->Strategies().size(); j++) {
-	  p_lhs[rowno] += profile[player->GetStrategy(j)];
+	  p_lhs[rowno] += m_profile[player->GetStrategy(j)];
 	}
       }
       else {
 	// This is a ratio equation
-	p_lhs[rowno] = (logprofile[player->GetStrategy(st)] - 
-			logprofile[player->GetStrategy(1)] -
-			lambda * (profile.GetPayoff(player->GetStrategy(st)) -
-				  profile.GetPayoff(player->GetStrategy(1))));
+	p_lhs[rowno] = (p_point[rowno] - p_point[first] -
+			lambda * (m_strategyPayoffs[rowno] - 
+				  m_strategyPayoffs[first]));
 
       }
     }
@@ -87,19 +127,19 @@ void
 StrategicQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_point,
 						    Matrix<double> &p_matrix) const
 {
-  MixedStrategyProfile<double> profile(m_game->NewMixedStrategyProfile(0.0)), logprofile(m_game->NewMixedStrategyProfile(0.0));
-  for (int i = 1; i <= profile.MixedProfileLength(); i++) {
-    profile[i] = exp(p_point[i]);
-    logprofile[i] = p_point[i];
-  }
+  SetPoint(p_point);
   double lambda = p_point[p_point.Length()];
 
   p_matrix = 0.0;
 
   for (int rowno = 0, i = 1; i <= m_game->NumPlayers(); i++) {
     GamePlayer player = m_game->Players()[i];
+    m_profile.GetPayoffDerivs(i, m_payoffs, m_payoffs2);
+    // Index in the profile of the player's first strategy
+    int first = rowno + 1;
     for (int j = 1; j <= player->Strategies().size(); j++) {
       rowno++;
+      m_strategyPayoffs[rowno] = m_payoffs[rowno];
       if (j == 1) {
 	// This is a sum-to-one equation
 	for (int colno = 0, ell = 1; ell <= m_game->NumPlayers(); ell++) {
@@ -107,7 +147,7 @@ StrategicQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_poin
 	  for (int m = 1; m <= player2->Strategies().size(); m++) {
 	    colno++;
 	    if (i == ell) {
-	      p_matrix(colno, rowno) = profile[player2->GetStrategy(m)];
+	      p_matrix(colno, rowno) = m_profile[player2->GetStrategy(m)];
 	    }
 	    // Otherwise, entry is zero
 	  }
@@ -131,23 +171,18 @@ StrategicQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_poin
 	    }
 	    else {
 	      p_matrix(colno, rowno) =
-		-lambda * profile[player2->GetStrategy(m)] *
-		(profile.GetPayoffDeriv(i, 
-					player->GetStrategy(j),
-					player2->GetStrategy(m)) -
-		 profile.GetPayoffDeriv(i, 
-					player->GetStrategy(1),
-					player2->GetStrategy(m)));
+		-lambda * m_profile[player2->GetStrategy(m)] *
+		(m_payoffs2(rowno, colno) - m_payoffs2(first, colno));
 	    }
 	  }
 	}
 	// Fill the last column, the derivative wrt lambda
 	p_matrix(p_matrix.NumRows(), rowno) =
-	  (profile.GetPayoff(player->GetStrategy(1)) - 
-	   profile.GetPayoff(player->GetStrategy(j)));
+	  (m_payoffs[first] - m_payoffs[rowno]);
       }
     }
   }
+  m_payoffsValid = true;
 }
 
 //----------------------------------------------------------------------------
@@ -186,7 +221,7 @@ public:
   
 private:
   std::ostream &m_stream;
-  const Game &m_game;
+  Game m_game;
   bool m_fullGraph;
   double m_decimals;
   mutable List<LogitQREMixedStrategyProfile> m_profiles;
@@ -315,7 +350,7 @@ private:
   void PrintProfile(const MixedStrategyProfile<double> &, double) const;
 
   std::ostream &m_stream;
-  const Game &m_game;
+  Game m_game;
   const Vector<double> &m_frequencies;
   bool m_fullGraph;
   double m_decimals;
@@ -386,6 +421,91 @@ StrategicQREEstimator::CallbackFunction::operator()(const Vector<double> &x,
   }
 }
 
+//----------------------------------------------------------------------------
+//            StrategicQREEstimator: Callback function for batches
+//----------------------------------------------------------------------------
+
+//
+// Records the points along the path, and for each set of frequencies the
+// point at which the log-likelihood is greatest.  The path is traced in
+// terms of the logarithms of the probabilities, so each log-likelihood
+// is just the inner product of the frequencies with the point.
+//
+class StrategicQREEstimator::BatchCallbackFunction : public PathTracer::CallbackFunction {
+public:
+  BatchCallbackFunction(const List<MixedStrategyProfile<double> > &p_frequencies,
+			const double &p_omega);
+  virtual ~BatchCallbackFunction() { }
+
+  virtual void operator()(const Vector<double> &p_point,
+			  bool p_isTerminal) const;
+
+  int NumPoints(void) const { return m_points.Length(); }
+  const Vector<double> &GetPoint(int i) const { return m_points[i]; }
+  // The orientation of the path when leaving the i'th point
+  double GetOmega(int i) const
+  { return (i < m_omegas.Length()) ? m_omegas[i+1] : m_omega; }
+
+  int GetBestPoint(int p_index) const { return m_best[p_index]; }
+  double GetLogLike(int p_index, int i) const
+  { return GetLogLike(p_index, m_points[i]); }
+
+private:
+  double GetLogLike(int p_index, const Vector<double> &p_point) const;
+
+  const double &m_omega;
+  Matrix<double> m_frequencies;
+  mutable List<Vector<double> > m_points;
+  // The orientation in effect on arriving at each point
+  mutable List<double> m_omegas;
+  mutable Array<int> m_best;
+  mutable Array<double> m_maxlogL;
+};
+
+StrategicQREEstimator::BatchCallbackFunction::BatchCallbackFunction(const List<MixedStrategyProfile<double> > &p_frequencies,
+								    const double &p_omega)
+  : m_omega(p_omega),
+    m_frequencies(p_frequencies.Length(), 
+		  p_frequencies[1].MixedProfileLength()),
+    m_best(p_frequencies.Length()), m_maxlogL(p_frequencies.Length())
+{
+  for (int k = 1; k <= p_frequencies.Length(); k++) {
+    for (int i = 1; i <= m_frequencies.NumColumns(); i++) {
+      m_frequencies(k, i) = p_frequencies[k][i];
+    }
+  }
+}
+
+double 
+StrategicQREEstimator::BatchCallbackFunction::GetLogLike(int p_index, 
+							 const Vector<double> &p_point) const
+{
+  double logL = 0.0;
+  for (int j = 1; j <= m_frequencies.NumColumns(); j++) {
+    logL += m_frequencies(p_index, j) * p_point[j];
+  }
+  return logL;
+}
+
+void
+StrategicQREEstimator::BatchCallbackFunction::operator()(const Vector<double> &x,
+							 bool p_isTerminal) const
+{
+  if (p_isTerminal) {
+    // The terminal point is the last point already recorded
+    return;
+  }
+  m_points.Append(x);
+  m_omegas.Append(m_omega);
+  for (int k = 1; k <= m_frequencies.NumRows(); k++) {
+    double logL = GetLogLike(k, x);
+    if (m_points.Length() == 1 || logL > m_maxlogL[k]) {
+      m_maxlogL[k] = logL;
+      m_best[k] = m_points.Length();
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 //               StrategicQREEstimator: Main driver routine
 //----------------------------------------------------------------------------
@@ -423,4 +543,89 @@ StrategicQREEstimator::Estimate(const LogitQREMixedStrategyProfile &p_start,
   return callback.GetMaximizer();
 }
 
+List<LogitQREMixedStrategyProfile>
+StrategicQREEstimator::Estimate(const LogitQREMixedStrategyProfile &p_start,
+				const List<MixedStrategyProfile<double> > &p_frequencies,
+				std::ostream &p_stream,
+				double p_maxLambda, double p_omega)
+{
+  for (int k = 1; k <= p_frequencies.Length(); k++) {
+    if (p_start.GetGame() != p_frequencies[k].GetGame()) {
+      throw MismatchException();
+    }
+  }
+  List<LogitQREMixedStrategyProfile> maximizers;
+  if (p_frequencies.Length() == 0) {
+    return maximizers;
+  }
+
+  Vector<double> x(p_start.MixedProfileLength() + 1);
+  for (int i = 1; i <= p_start.MixedProfileLength(); i++) {
+    x[i] = log(p_start[i]);
+  }
+  x[x.Length()] = p_start.GetLambda();
+
+  double omega = p_omega;
+  BatchCallbackFunction callback(p_frequencies, omega);
+  TracePath(EquationSystem(p_start.GetGame()), x, p_maxLambda, omega,
+	    callback);
+
+  // Each maximizer is then located precisely by retracing the segment of
+  // the path adjacent to the best point, on the side with the greater
+  // likelihood, searching for an extremum as in the single estimation.
+  // Lambda need not increase along the segment, so the retrace is bounded
+  // by arc length, allowing for the curvature of the path and for the
+  // secant steps in locating the extremum.
+  SettingsGuard guard(*this);
+  for (int k = 1; k <= p_frequencies.Length(); k++) {
+    int best = callback.GetBestPoint(k);
+    int from = best;
+    if (best == callback.NumPoints() ||
+	(best > 1 && 
+	 callback.GetLogLike(k, best - 1) > callback.GetLogLike(k, best + 1))) {
+      from = best - 1;
+    }
+
+    Vector<double> point(callback.GetPoint(best));
+    if (from >= 1) {
+      List<MixedStrategyProfile<double> > frequencies;
+      frequencies.Append(p_frequencies[k]);
+      const Vector<double> &to = callback.GetPoint(from + 1);
+      Vector<double> y(callback.GetPoint(from));
+      double segmentOmega = callback.GetOmega(from);
+      BatchCallbackFunction segment(frequencies, segmentOmega);
+      double length = std::sqrt((to - y).NormSquared());
+      SetStepsize(0.25 * length);
+      SetMaxLength(2.0 * length);
+      TracePath(EquationSystem(p_start.GetGame()), y, p_maxLambda, 
+		segmentOmega, segment, CriterionFunction(p_frequencies[k]));
+      if (segment.GetLogLike(1, segment.GetBestPoint(1)) > 
+	  callback.GetLogLike(k, best)) {
+	point = segment.GetPoint(segment.GetBestPoint(1));
+      }
+    }
+
+    MixedStrategyProfile<double> profile(p_start.GetGame()->NewMixedStrategyProfile(0.0));
+    for (int i = 1; i <= profile.MixedProfileLength(); i++) {
+      profile[i] = exp(point[i]);
+    }
+    maximizers.Append(LogitQREMixedStrategyProfile(profile, 
+						   point[point.Length()]));
+
+    p_stream.setf(std::ios::fixed);
+    // By convention, we output lambda first
+    p_stream << std::setprecision(m_decimals) << point[point.Length()];
+    p_stream.unsetf(std::ios::fixed);
+    for (int i = 1; i <= profile.MixedProfileLength(); i++) {
+      p_stream << "," << std::setprecision(m_decimals) << profile[i];
+    }
+    p_stream.setf(std::ios::fixed);
+    p_stream << "," << std::setprecision(m_decimals);
+    p_stream << LogLike(p_frequencies[k], profile);
+    p_stream.unsetf(std::ios::fixed);
+    p_stream << std::endl;
+  }
+  return maximizers;
+}
+
 }   // end namespace Gambit
@@ -98,10 +98,19 @@ public:
            const MixedStrategyProfile<double> &p_frequencies,
 	   std::ostream &p_logStream,
 	   double p_maxLambda, double p_omega);
+  // Estimates for each of a list of observed frequencies, tracing the
+  // correspondence only once.  The maximizers are returned (and written
+  // to the log stream) in the order of the frequencies.
+  List<LogitQREMixedStrategyProfile>
+  Estimate(const LogitQREMixedStrategyProfile &p_start,
+           const List<MixedStrategyProfile<double> > &p_frequencies,
+	   std::ostream &p_logStream,
+	   double p_maxLambda, double p_omega);
   
 protected:
   class CriterionFunction;
   class CallbackFunction;
+  class BatchCallbackFunction;
 };
 
 }  // end namespace Gambit
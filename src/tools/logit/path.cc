@@ -22,10 +22,10 @@
 
 #include <cmath>
 #include <algorithm>   // for std::max
+#include <vector>
 #include <iostream>
 
 #include <libgambit/libgambit.h>
-#include <libgambit/sqmatrix.h>
 #include "path.h"
 
 namespace Gambit {
@@ -38,10 +38,55 @@ namespace {
   
 inline double sqr(double x) { return x*x; }
 
-void Givens(Matrix<double> &b, Matrix<double> &q,
+//
+// The orthogonal factor of the QR decomposition is kept as the sequence
+// of Givens rotations which make it up, rather than accumulated into a
+// matrix.  The tracer only ever needs the product of (the transpose of)
+// this factor with a vector, which the rotations give directly; this
+// avoids both the storage of a dense square matrix and the cost of
+// updating a full row of it with each rotation.
+//
+// The Jacobians passed to the tracer also typically have many entries
+// which are exactly zero.  No rotation is generated for an entry which
+// is already zero, provided the rotation would be the identity.
+//
+class GivensRotations {
+public:
+  /// Removes all rotations
+  void Clear(void) { m_rotations.clear(); }
+  /// Appends the rotation of entries l1 and l2 with cosine c and sine s
+  void Append(int l1, int l2, double c, double s)
+  { m_rotations.push_back(Rotation(l1, l2, c, s)); }
+  /// Replaces v by the product of the transpose of the factor with v
+  void TransposeMultiply(Vector<double> &v) const;
+
+private:
+  struct Rotation {
+    int l1, l2;
+    double c, s;
+
+    Rotation(int p_l1, int p_l2, double p_c, double p_s)
+      : l1(p_l1), l2(p_l2), c(p_c), s(p_s) { }
+  };
+
+  std::vector<Rotation> m_rotations;
+};
+
+void GivensRotations::TransposeMultiply(Vector<double> &v) const
+{
+  for (int i = m_rotations.size() - 1; i >= 0; i--) {
+    const Rotation &r = m_rotations[i];
+    double sv1 = v[r.l1];
+    double sv2 = v[r.l2];
+    v[r.l1] = r.c * sv1 - r.s * sv2;
+    v[r.l2] = r.s * sv1 + r.c * sv2;
+  }
+}
+
+void Givens(Matrix<double> &b, GivensRotations &q,
             double &c1, double &c2, int l1, int l2, int l3)
 {
-  if (fabs(c1) + fabs(c2) == 0.0) {
+  if (c2 == 0.0 && c1 >= 0.0) {
     return;
   }
 
@@ -55,12 +100,7 @@ void Givens(Matrix<double> &b, Matrix<double> &q,
   double s1 = c1/sn;
   double s2 = c2/sn;
 
-  for (int k = 1; k <= q.NumColumns(); k++) {
-    double sv1 = q(l1, k);
-    double sv2 = q(l2, k);
-    q(l1, k) = s1 * sv1 + s2 * sv2;
-    q(l2, k) = -s2 * sv1 + s1 * sv2;
-  }
+  q.Append(l1, l2, s1, s2);
 
   for (int k = l3; k <= b.NumColumns(); k++) {
     double sv1 = b(l1, k);
@@ -73,9 +113,9 @@ void Givens(Matrix<double> &b, Matrix<double> &q,
   c2 = 0.0;
 }
 
-void QRDecomp(Matrix<double> &b, Matrix<double> &q)
+void QRDecomp(Matrix<double> &b, GivensRotations &q)
 {
-  q.MakeIdent();
+  q.Clear();
   for (int m = 1; m <= b.NumColumns(); m++) {
     for (int k = m + 1; k <= b.NumRows(); k++) {
       Givens(b, q, b(m, m), b(k, m), m, k, m + 1);
@@ -83,9 +123,17 @@ void QRDecomp(Matrix<double> &b, Matrix<double> &q)
   }
 }
 
-void NewtonStep(Matrix<double> &q, Matrix<double> &b,
+/// Sets t to the tangent of the curve, given the decomposition q
+void GetTangent(const GivensRotations &q, Vector<double> &t)
+{
+  t = 0.0;
+  t[t.Length()] = 1.0;
+  q.TransposeMultiply(t);
+}
+
+void NewtonStep(const GivensRotations &q, Matrix<double> &b,
                 Vector<double> &u, Vector<double> &y,
-		double &d)
+		Vector<double> &w, double &d)
 {
   for (int k = 1; k <= b.NumColumns(); k++) {
     for (int l = 1; l <= k - 1; l++) {
@@ -94,14 +142,16 @@ void NewtonStep(Matrix<double> &q, Matrix<double> &b,
     y[k] /= b(k, k);
   }
 
+  for (int k = 1; k <= b.NumColumns(); k++) {
+    w[k] = y[k];
+  }
+  w[w.Length()] = 0.0;
+  q.TransposeMultiply(w);
+
   d = 0.0;
   for (int k = 1; k <= b.NumRows(); k++) {
-    double s = 0.0;
-    for (int l = 1; l <= b.NumColumns(); l++) {
-      s += q(l, k) * y[l];
-    }
-    u[k] -= s;
-    d += s * s;
+    u[k] -= w[k];
+    d += w[k] * w[k];
   }
   d = std::sqrt(d);
 }
@@ -128,23 +178,41 @@ PathTracer::TracePath(const EquationSystem &p_system,
   double h = m_hStart;             // initial stepsize
   const double c_hmin = 1.0e-8;    // minimal stepsize
   const int c_maxIter = 100;       // maximum iterations in corrector
+
+  // Parameters used only in adaptive mode
+  const double c_predTol = 0.02;   // target distance of prediction to curve
+  const double c_minCos = 0.95;    // minimal cosine of angle between tangents
+  const double c_maxGrow = 2.0;    // maximal increase of stepsize per step
+  const double c_minGrow = 0.5;    // maximal decrease of stepsize per step
+  const int c_maxAdaptIter = 8;    // maximum iterations in corrector
   
   bool newton = false;             // using Newton steplength (for zero-finding)
+  double length = 0.0;             // arc length followed so far
 
   Vector<double> u(x.Length()), restart(x.Length());
   // t is current tangent at x; newT is tangent at u, which is the next point.
   Vector<double> t(x.Length()), newT(x.Length());
-  Vector<double> y(x.Length() - 1);
+  Vector<double> y(x.Length() - 1), w(x.Length());
   Matrix<double> b(x.Length(), x.Length() - 1);
-  SquareMatrix<double> q(x.Length());
+  GivensRotations q;
+  // In adaptive mode, the corrector uses the decomposition at x, and
+  // the decomposition at u is computed once the corrector has converged.
+  // Also kept are the previous point on the curve and the direction of
+  // travel there, and the predicted point before correction.
+  Matrix<double> newB(x.Length(), x.Length() - 1);
+  GivensRotations newQ;
+  Vector<double> prevX(x.Length()), prevDir(x.Length()), pred(x.Length());
+  bool havePrev = false;
 
   p_callback(x, false);
   p_system.GetJacobian(x, b);
   QRDecomp(b, q);
-  q.GetRow(q.NumRows(), t);
+  GetTangent(q, t);
   
-  while (x[x.Length()] >= 0.0 && x[x.Length()] < p_maxLambda) {
+  while (x[x.Length()] >= 0.0 && x[x.Length()] < p_maxLambda &&
+	 (m_maxLength <= 0.0 || length < m_maxLength)) {
     bool accept = true;
+    bool adaptive = m_adaptive && !newton;
 
     if (fabs(h) <= c_hmin) {
       if (newton) {
@@ -155,13 +223,39 @@ PathTracer::TracePath(const EquationSystem &p_system,
     }
 
     // Predictor step
-    for (int k = 1; k <= x.Length(); k++) {
-      u[k] = x[k] + h * p_omega * t[k];
+    if (adaptive && havePrev) {
+      // Extrapolate along the cubic which interpolates the last two
+      // points and the directions of travel there, parametrized
+      // (approximately) by arclength.
+      double len = 0.0;
+      for (int k = 1; k <= x.Length(); k++) {
+	len += sqr(x[k] - prevX[k]);
+      }
+      len = std::sqrt(len);
+      for (int k = 1; k <= x.Length(); k++) {
+	double dir = p_omega * t[k];
+	double r1 = prevX[k] - x[k] + len * dir;
+	double r2 = prevDir[k] - dir;
+	double c2 = (3.0 * r1 + len * r2) / (len * len);
+	double c3 = (r2 + 2.0 * r1 / len) / (len * len);
+	u[k] = x[k] + h * (dir + h * (c2 + h * c3));
+      }
+    }
+    else {
+      for (int k = 1; k <= x.Length(); k++) {
+	u[k] = x[k] + h * p_omega * t[k];
+      }
     }
 
     double decel = 1.0 / m_maxDecel;  // initialize deceleration factor
-    p_system.GetJacobian(u, b);
-    QRDecomp(b, q);
+    double contrRatio = 0.0;          // largest contraction relative to max
+    if (adaptive) {
+      pred = u;
+    }
+    else {
+      p_system.GetJacobian(u, b);
+      QRDecomp(b, q);
+    }
 
     int iter = 1;
     double disto = 0.0;
@@ -169,7 +263,7 @@ PathTracer::TracePath(const EquationSystem &p_system,
       double dist;
 
       p_system.GetValue(u, y);
-      NewtonStep(q, b, u, y, dist); 
+      NewtonStep(q, b, u, y, w, dist); 
 
       if (dist >= c_maxDist) {
 	accept = false;
@@ -184,6 +278,7 @@ PathTracer::TracePath(const EquationSystem &p_system,
 	  break;
 	}
 	decel = std::max(decel, std::sqrt(contr / c_maxContr) * m_maxDecel);
+	contrRatio = std::max(contrRatio, contr / c_maxContr);
       }
 
       if (dist <= c_tol) {
@@ -192,6 +287,11 @@ PathTracer::TracePath(const EquationSystem &p_system,
       }
       disto = dist;
       iter++;
+      if (adaptive && iter > c_maxAdaptIter && fabs(h) > m_hStart) {
+	// Corrector is converging too slowly; retry with a shorter step
+	accept = false;
+	break;
+      }
       if (iter > c_maxIter) {
 	p_callback(x, true);
 	if (newton) {
@@ -202,8 +302,24 @@ PathTracer::TracePath(const EquationSystem &p_system,
       }
     }
 
+    if (accept && adaptive) {
+      // Obtain the tangent at the next step.  If the direction of the
+      // curve changes sharply over the step, the corrector may have
+      // converged to a nearby branch.
+      p_system.GetJacobian(u, newB);
+      QRDecomp(newB, newQ);
+      GetTangent(newQ, newT);
+      accept = (fabs(t * newT) >= c_minCos || fabs(h) <= m_hStart);
+    }
+
     if (!accept) {
-      h /= m_maxDecel;   // PC not accepted; change stepsize and retry
+      // PC not accepted; change stepsize and retry
+      if (adaptive) {
+	h *= c_minGrow;
+      }
+      else {
+	h /= m_maxDecel;
+      }
       if (fabs(h) <= c_hmin) {
 	p_callback(x, true);
 	if (newton) {
@@ -221,8 +337,10 @@ PathTracer::TracePath(const EquationSystem &p_system,
       decel = m_maxDecel;
     }
 
-    // Obtain the tangent at the next step
-    q.GetRow(q.NumRows(), newT); 
+    if (!adaptive) {
+      // Obtain the tangent at the next step
+      GetTangent(q, newT);
+    }
 
     // If we are at a bifurcation point, the orientation of the tangent
     // will flip.  This will confuse many criterion functions, especially
@@ -240,12 +358,45 @@ PathTracer::TracePath(const EquationSystem &p_system,
       // Newton-type steplength adaptation, secant method
       h *= -p_criterion(u, newT) / (p_criterion(u, newT) - p_criterion(x, t));
     }
+    else if (adaptive) {
+      // Steplength adaptation based on the distance from the prediction
+      // to the curve, which estimates the error of the predictor, and on
+      // the contraction observed in the corrector
+      double err = 0.0;
+      for (int k = 1; k <= x.Length(); k++) {
+	err += sqr(u[k] - pred[k]);
+      }
+      err = std::sqrt(err);
+      double factor = c_maxGrow;
+      if (err > 0.0) {
+	factor = std::min(factor, std::pow(c_predTol / err,
+					   (havePrev) ? 0.25 : 0.5));
+      }
+      if (contrRatio > 0.0) {
+	factor = std::min(factor, 1.0 / std::sqrt(contrRatio));
+      }
+      h = fabs(h * std::max(factor, c_minGrow));
+    }
     else {
       // Standard steplength adaptation
       h = fabs(h / decel);
     }
 
     // PC step was successful; update and iterate
+    if (adaptive) {
+      prevX = x;
+      for (int k = 1; k <= x.Length(); k++) {
+	prevDir[k] = p_omega * t[k];
+      }
+      havePrev = true;
+      b = newB;
+      q = newQ;
+    }
+    double step = 0.0;
+    for (int k = 1; k <= x.Length(); k++) {
+      step += sqr(u[k] - x[k]);
+    }
+    length += std::sqrt(step);
     x = u;
     p_callback(x, false);
 
@@ -254,6 +405,8 @@ PathTracer::TracePath(const EquationSystem &p_system,
       // taking into account the change in orientation of the curve.
       // Someday, we need to do more here!
       p_omega = -p_omega;
+      // Do not extrapolate across the bifurcation
+      havePrev = false;
     }
     t = newT;
   }
@@ -94,8 +94,45 @@ public:
   void SetStepsize(double p_hStart) { m_hStart = p_hStart; }
   double GetStepsize(void) const { return m_hStart; }
 
+  //
+  // Tracing stops once the path has been followed for the given arc
+  // length, as well as when lambda leaves [0, maxLambda).  A length
+  // which is not positive sets no limit.
+  //
+  void SetMaxLength(double p_maxLength) { m_maxLength = p_maxLength; }
+  double GetMaxLength(void) const { return m_maxLength; }
+
+  //
+  // Saves the stepsize and maximum length of a tracer, and restores
+  // them when it goes out of scope, however the scope is left.
+  //
+  class SettingsGuard {
+  public:
+    SettingsGuard(PathTracer &p_tracer)
+      : m_tracer(p_tracer), m_hStart(p_tracer.GetStepsize()),
+	m_maxLength(p_tracer.GetMaxLength()) { }
+    ~SettingsGuard()
+      { m_tracer.SetStepsize(m_hStart); m_tracer.SetMaxLength(m_maxLength); }
+
+  private:
+    PathTracer &m_tracer;
+    double m_hStart, m_maxLength;
+  };
+
+  //
+  // In adaptive mode, the predictor extrapolates along a cubic through
+  // the last two points on the curve, and the stepsize is chosen from the
+  // observed error of the predictor, rather than being limited to change
+  // by at most the maximum deceleration at each step.  Steps over which
+  // the corrector converges slowly, or the direction of the curve changes
+  // sharply, are retried with a shorter stepsize.
+  //
+  void SetAdaptive(bool p_adaptive) { m_adaptive = p_adaptive; }
+  bool IsAdaptive(void) const { return m_adaptive; }
+
 protected:
-  PathTracer(void) : m_maxDecel(1.1), m_hStart(0.03)
+  PathTracer(void)
+    : m_maxDecel(1.1), m_hStart(0.03), m_maxLength(0.0), m_adaptive(false)
     { } 
   virtual ~PathTracer() { }
 
@@ -105,7 +142,8 @@ protected:
 		 const CriterionFunction &p_criterion = NullCriterionFunction()) const;
 
 private:
-  double m_maxDecel, m_hStart;
+  double m_maxDecel, m_hStart, m_maxLength;
+  bool m_adaptive;
 };
 
 }  // end namespace Gambit
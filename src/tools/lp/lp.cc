@@ -22,7 +22,6 @@
 //
 
 #include <iostream>
-#include <fstream>
 #include <cerrno>
 #include <cstdlib>
 #include <unistd.h>
@@ -112,21 +111,11 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
-  std::istream* input_stream = &std::cin;
-  std::ifstream file_stream;
-  if (optind < argc) {
-    file_stream.open(argv[optind]);
-    if (!file_stream.is_open()) {
-      std::ostringstream error_message;
-      error_message << argv[0] << ": " << argv[optind];
-      perror(error_message.str().c_str());
-      exit(1);
-    }
-    input_stream = &file_stream;
-  }
-
   try {
-    Gambit::Game game = Gambit::ReadGame(*input_stream);
+    // Files are read by name, which lets them be mapped into memory
+    Gambit::Game game = ((optind < argc) ?
+			  Gambit::ReadGame(std::string(argv[optind])) :
+			  Gambit::ReadGame(std::cin));
     if (!game->IsTree() || useStrategic) {
       if (useFloat) {
 	shared_ptr<StrategyProfileRenderer<double> > renderer;